@@ -0,0 +1,847 @@
+#pragma once
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <array>
+#include <cmath>
+#include <type_traits>
+#include <vector>
+
+#if JUCE_USE_SSE_INTRINSICS
+ #include <emmintrin.h>
+#elif JUCE_USE_ARM_NEON
+ #include <arm_neon.h>
+#endif
+
+// Whether kernels::detail has double-precision vector loops: SSE2, or NEON on AArch64 (32-bit
+// ARM has no 64-bit lanes). Always defined, to 0 or 1.
+#if (defined(JUCE_USE_SSE_INTRINSICS) && JUCE_USE_SSE_INTRINSICS) \
+    || (defined(JUCE_USE_ARM_NEON) && JUCE_USE_ARM_NEON && defined(__aarch64__))
+ #define VIAU_HAS_DOUBLE_KERNELS 1
+#else
+ #define VIAU_HAS_DOUBLE_KERNELS 0
+#endif
+
+// Header-only metering core shared by ViaU-Version1 and ViaU-Version2.
+//
+// A meter is assembled from compile-time policies:
+//
+//     viau::Meter<Detector, Ballistics, NumChannels, SampleType>
+//
+//   Detector     AbsDetector (rectified average), RmsDetector (mean square), PeakDetector
+//   Ballistics   VUBallistics (300 ms one-pole), PPMType1Ballistics, PPMType2Ballistics,
+//                CustomBallistics (attack/release set at runtime)
+//   NumChannels  a fixed channel count, or dynamicChannelCount (up to maxChannels)
+//   SampleType   float or double
+//
+// Every choice is resolved at compile time, so each combination gets its own inner loop with
+// no per-sample or per-channel branching on the meter type. Adding a meter type means adding
+// a policy; existing instantiations do not change.
+namespace viau
+{
+    static constexpr int maxChannels = 64;
+    static constexpr int dynamicChannelCount = 0;
+
+    //==============================================================================
+    // SIMD kernels. The float versions use SSE/NEON when JUCE enables them, the double versions
+    // SSE2 or AArch64 NEON; everything else falls back to the scalar loop, which doubles as
+    // the reference.
+    namespace kernels
+    {
+        // sum_i |x[i]| * w[i]
+        template <typename T>
+        inline T weightedAbsSum(const T* x, const T* w, int n) noexcept
+        {
+            T sum = 0;
+            for (int i = 0; i < n; ++i)
+                sum += std::abs(x[i]) * w[i];
+            return sum;
+        }
+
+        // sum_i x[i]^2 * w[i]
+        template <typename T>
+        inline T weightedSquareSum(const T* x, const T* w, int n) noexcept
+        {
+            T sum = 0;
+            for (int i = 0; i < n; ++i)
+                sum += x[i] * x[i] * w[i];
+            return sum;
+        }
+
+        // sum_i |x[i]|, the box filter of the decimated detection mode
+        template <typename T>
+        inline T absSum(const T* x, int n) noexcept
+        {
+            T sum = 0;
+            for (int i = 0; i < n; ++i)
+                sum += std::abs(x[i]);
+            return sum;
+        }
+
+        // sum_i x[i]^2
+        template <typename T>
+        inline T squareSum(const T* x, int n) noexcept
+        {
+            T sum = 0;
+            for (int i = 0; i < n; ++i)
+                sum += x[i] * x[i];
+            return sum;
+        }
+
+        // sum_i l[i] * r[i], l[i]^2 and r[i]^2 in one pass, for phase correlation
+        template <typename T>
+        struct StereoSums
+        {
+            T lr = 0, ll = 0, rr = 0;
+        };
+
+        template <typename T>
+        inline StereoSums<T> stereoSums(const T* l, const T* r, int n) noexcept
+        {
+            StereoSums<T> sums;
+            for (int i = 0; i < n; ++i)
+            {
+                sums.lr += l[i] * r[i];
+                sums.ll += l[i] * l[i];
+                sums.rr += r[i] * r[i];
+            }
+            return sums;
+        }
+
+        // One vector loop per ISA and precision. Square selects x^2 over |x|, Weighted whether
+        // w is read at all.
+        namespace detail
+        {
+            template <bool Square, bool Weighted, typename T>
+            inline T scalarTail(const T* x, const T* w, int i, int n, T sum) noexcept
+            {
+                for (; i < n; ++i)
+                {
+                    const T r = Square ? x[i] * x[i] : std::abs(x[i]);
+                    if constexpr (Weighted)
+                        sum += r * w[i];
+                    else
+                        sum += r;
+                }
+                return sum;
+            }
+
+            template <typename T>
+            inline StereoSums<T> stereoTail(const T* l, const T* r, int i, int n, StereoSums<T> sums) noexcept
+            {
+                for (; i < n; ++i)
+                {
+                    sums.lr += l[i] * r[i];
+                    sums.ll += l[i] * l[i];
+                    sums.rr += r[i] * r[i];
+                }
+                return sums;
+            }
+
+           #if JUCE_USE_SSE_INTRINSICS
+            inline float horizontalSum(__m128 v) noexcept
+            {
+                alignas(16) float lanes[4];
+                _mm_store_ps(lanes, v);
+                return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+            }
+
+            inline double horizontalSum(__m128d v) noexcept
+            {
+                alignas(16) double lanes[2];
+                _mm_store_pd(lanes, v);
+                return lanes[0] + lanes[1];
+            }
+
+            template <bool Square, bool Weighted>
+            inline float sum(const float* x, const float* w, int n) noexcept
+            {
+                const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+                auto term = [&](int i)
+                    {
+                        const __m128 v = _mm_loadu_ps(x + i);
+                        const __m128 r = Square ? _mm_mul_ps(v, v) : _mm_and_ps(v, absMask);
+                        if constexpr (Weighted)
+                            return _mm_mul_ps(r, _mm_loadu_ps(w + i));
+                        else
+                            return r;
+                    };
+
+                __m128 acc0 = _mm_setzero_ps();
+                __m128 acc1 = _mm_setzero_ps();
+                int i = 0;
+
+                for (; i + 8 <= n; i += 8)
+                {
+                    acc0 = _mm_add_ps(acc0, term(i));
+                    acc1 = _mm_add_ps(acc1, term(i + 4));
+                }
+
+                for (; i + 4 <= n; i += 4)
+                    acc0 = _mm_add_ps(acc0, term(i));
+
+                return scalarTail<Square, Weighted>(x, w, i, n, horizontalSum(_mm_add_ps(acc0, acc1)));
+            }
+
+            template <bool Square, bool Weighted>
+            inline double sum(const double* x, const double* w, int n) noexcept
+            {
+                const __m128d absMask = _mm_castsi128_pd(_mm_set1_epi64x(0x7fffffffffffffffLL));
+                auto term = [&](int i)
+                    {
+                        const __m128d v = _mm_loadu_pd(x + i);
+                        const __m128d r = Square ? _mm_mul_pd(v, v) : _mm_and_pd(v, absMask);
+                        if constexpr (Weighted)
+                            return _mm_mul_pd(r, _mm_loadu_pd(w + i));
+                        else
+                            return r;
+                    };
+
+                __m128d acc0 = _mm_setzero_pd();
+                __m128d acc1 = _mm_setzero_pd();
+                int i = 0;
+
+                for (; i + 4 <= n; i += 4)
+                {
+                    acc0 = _mm_add_pd(acc0, term(i));
+                    acc1 = _mm_add_pd(acc1, term(i + 2));
+                }
+
+                return scalarTail<Square, Weighted>(x, w, i, n, horizontalSum(_mm_add_pd(acc0, acc1)));
+            }
+
+            inline StereoSums<float> stereoSums(const float* l, const float* r, int n) noexcept
+            {
+                __m128 lr = _mm_setzero_ps(), ll = _mm_setzero_ps(), rr = _mm_setzero_ps();
+                int i = 0;
+
+                for (; i + 4 <= n; i += 4)
+                {
+                    const __m128 vl = _mm_loadu_ps(l + i);
+                    const __m128 vr = _mm_loadu_ps(r + i);
+                    lr = _mm_add_ps(lr, _mm_mul_ps(vl, vr));
+                    ll = _mm_add_ps(ll, _mm_mul_ps(vl, vl));
+                    rr = _mm_add_ps(rr, _mm_mul_ps(vr, vr));
+                }
+
+                StereoSums<float> sums { horizontalSum(lr), horizontalSum(ll), horizontalSum(rr) };
+                return stereoTail(l, r, i, n, sums);
+            }
+           #elif JUCE_USE_ARM_NEON
+            inline float horizontalSum(float32x4_t v) noexcept
+            {
+                const float32x2_t half = vadd_f32(vget_low_f32(v), vget_high_f32(v));
+                return vget_lane_f32(vpadd_f32(half, half), 0);
+            }
+
+            template <bool Square, bool Weighted>
+            inline float sum(const float* x, const float* w, int n) noexcept
+            {
+                auto accumulate = [&](float32x4_t acc, int i)
+                    {
+                        const float32x4_t v = vld1q_f32(x + i);
+                        const float32x4_t r = Square ? vmulq_f32(v, v) : vabsq_f32(v);
+                        if constexpr (Weighted)
+                            return vmlaq_f32(acc, r, vld1q_f32(w + i));
+                        else
+                            return vaddq_f32(acc, r);
+                    };
+
+                float32x4_t acc0 = vdupq_n_f32(0.0f);
+                float32x4_t acc1 = vdupq_n_f32(0.0f);
+                int i = 0;
+
+                for (; i + 8 <= n; i += 8)
+                {
+                    acc0 = accumulate(acc0, i);
+                    acc1 = accumulate(acc1, i + 4);
+                }
+
+                for (; i + 4 <= n; i += 4)
+                    acc0 = accumulate(acc0, i);
+
+                return scalarTail<Square, Weighted>(x, w, i, n, horizontalSum(vaddq_f32(acc0, acc1)));
+            }
+
+            inline StereoSums<float> stereoSums(const float* l, const float* r, int n) noexcept
+            {
+                float32x4_t lr = vdupq_n_f32(0.0f), ll = vdupq_n_f32(0.0f), rr = vdupq_n_f32(0.0f);
+                int i = 0;
+
+                for (; i + 4 <= n; i += 4)
+                {
+                    const float32x4_t vl = vld1q_f32(l + i);
+                    const float32x4_t vr = vld1q_f32(r + i);
+                    lr = vmlaq_f32(lr, vl, vr);
+                    ll = vmlaq_f32(ll, vl, vl);
+                    rr = vmlaq_f32(rr, vr, vr);
+                }
+
+                StereoSums<float> sums { horizontalSum(lr), horizontalSum(ll), horizontalSum(rr) };
+                return stereoTail(l, r, i, n, sums);
+            }
+
+            // 64-bit NEON lanes only exist on AArch64; 32-bit ARM keeps the scalar double loop
+            #if VIAU_HAS_DOUBLE_KERNELS
+            template <bool Square, bool Weighted>
+            inline double sum(const double* x, const double* w, int n) noexcept
+            {
+                auto accumulate = [&](float64x2_t acc, int i)
+                    {
+                        const float64x2_t v = vld1q_f64(x + i);
+                        const float64x2_t r = Square ? vmulq_f64(v, v) : vabsq_f64(v);
+                        if constexpr (Weighted)
+                            return vfmaq_f64(acc, r, vld1q_f64(w + i));
+                        else
+                            return vaddq_f64(acc, r);
+                    };
+
+                float64x2_t acc0 = vdupq_n_f64(0.0);
+                float64x2_t acc1 = vdupq_n_f64(0.0);
+                int i = 0;
+
+                for (; i + 4 <= n; i += 4)
+                {
+                    acc0 = accumulate(acc0, i);
+                    acc1 = accumulate(acc1, i + 2);
+                }
+
+                return scalarTail<Square, Weighted>(x, w, i, n, vaddvq_f64(vaddq_f64(acc0, acc1)));
+            }
+            #endif
+           #endif
+        }
+
+       #if JUCE_USE_SSE_INTRINSICS || JUCE_USE_ARM_NEON
+        template <> inline float weightedAbsSum<float>(const float* x, const float* w, int n) noexcept      { return detail::sum<false, true>(x, w, n); }
+        template <> inline float weightedSquareSum<float>(const float* x, const float* w, int n) noexcept   { return detail::sum<true, true>(x, w, n); }
+        template <> inline float absSum<float>(const float* x, int n) noexcept                              { return detail::sum<false, false>(x, nullptr, n); }
+        template <> inline float squareSum<float>(const float* x, int n) noexcept                           { return detail::sum<true, false>(x, nullptr, n); }
+        template <> inline StereoSums<float> stereoSums<float>(const float* l, const float* r, int n) noexcept { return detail::stereoSums(l, r, n); }
+       #endif
+
+       #if VIAU_HAS_DOUBLE_KERNELS
+        template <> inline double weightedAbsSum<double>(const double* x, const double* w, int n) noexcept  { return detail::sum<false, true>(x, w, n); }
+        template <> inline double weightedSquareSum<double>(const double* x, const double* w, int n) noexcept { return detail::sum<true, true>(x, w, n); }
+        template <> inline double absSum<double>(const double* x, int n) noexcept                           { return detail::sum<false, false>(x, nullptr, n); }
+        template <> inline double squareSum<double>(const double* x, int n) noexcept                        { return detail::sum<true, false>(x, nullptr, n); }
+       #endif
+    }
+
+    //==============================================================================
+    // Detector policies: what is measured per sample, and how channels combine.
+    struct AbsDetector
+    {
+        static constexpr bool readsBlockMaximum = false;
+        static constexpr bool combinesByMaximum = false;
+
+        template <typename T> static T rectify(T x) noexcept { return std::abs(x); }
+        template <typename T> static T toLevel(T y) noexcept { return y; }
+        template <typename T> static T weightedSum(const T* x, const T* w, int n) noexcept { return kernels::weightedAbsSum(x, w, n); }
+        template <typename T> static T sum(const T* x, int n) noexcept { return kernels::absSum(x, n); }
+    };
+
+    struct RmsDetector
+    {
+        static constexpr bool readsBlockMaximum = false;
+        static constexpr bool combinesByMaximum = false;
+
+        template <typename T> static T rectify(T x) noexcept { return x * x; }
+        template <typename T> static T toLevel(T y) noexcept { return std::sqrt(y); }
+        template <typename T> static T weightedSum(const T* x, const T* w, int n) noexcept { return kernels::weightedSquareSum(x, w, n); }
+        template <typename T> static T sum(const T* x, int n) noexcept { return kernels::squareSum(x, n); }
+    };
+
+    // Reads the highest envelope value within each block, and the loudest channel overall.
+    struct PeakDetector
+    {
+        static constexpr bool readsBlockMaximum = true;
+        static constexpr bool combinesByMaximum = true;
+
+        template <typename T> static T rectify(T x) noexcept { return std::abs(x); }
+        template <typename T> static T toLevel(T y) noexcept { return y; }
+    };
+
+    //==============================================================================
+    // Ballistics policies.
+    //
+    // Linear ballistics (a symmetric one-pole) are evaluated per block in closed form:
+    //     y[N-1] = a^N * y[-1] + (1-a) * sum_j a^(N-1-j) * x[j]
+    // which turns the recursion into one weighted sum per channel that the kernels above can
+    // stream through. Attack/release ballistics are non-linear and run per sample.
+    template <int TimeConstantMs>
+    struct OnePoleBallistics
+    {
+        static constexpr bool isBlockLinear = true;
+        static constexpr double timeConstantSeconds = TimeConstantMs / 1000.0;
+    };
+
+    using VUBallistics = OnePoleBallistics<300>;
+
+    // IEC 60268-10 Type I (DIN): 5 ms integration, 20 dB fall in 1.7 s
+    struct PPMType1Ballistics
+    {
+        static constexpr bool isBlockLinear = false;
+        static constexpr double attackSeconds = 0.005;
+        static constexpr double releaseDbPerSecond = 20.0 / 1.7;
+    };
+
+    // IEC 60268-10 Type II (BBC): 10 ms integration, 24 dB fall in 2.8 s
+    struct PPMType2Ballistics
+    {
+        static constexpr bool isBlockLinear = false;
+        static constexpr double attackSeconds = 0.010;
+        static constexpr double releaseDbPerSecond = 24.0 / 2.8;
+    };
+
+    // Attack/release with times chosen at runtime through Meter::setAttackRelease()
+    struct CustomBallistics
+    {
+        static constexpr bool isBlockLinear = false;
+        static constexpr double attackSeconds = 0.010;
+        static constexpr double releaseDbPerSecond = 20.0;
+    };
+
+    //==============================================================================
+    template <typename Detector, typename Ballistics, int NumChannels = dynamicChannelCount, typename SampleType = float>
+    class Meter
+    {
+    public:
+        static_assert(std::is_floating_point<SampleType>::value, "SampleType must be float or double");
+        static_assert(NumChannels >= 0 && NumChannels <= maxChannels, "Unsupported channel count");
+        static_assert(!(Detector::readsBlockMaximum && Ballistics::isBlockLinear),
+                      "Peak reading needs per-sample (attack/release) ballistics");
+
+        static constexpr int channelCapacity = NumChannels == dynamicChannelCount ? maxChannels : NumChannels;
+
+        Meter() = default;
+
+        // Allocates; the tables are sized here, once per sample rate and block size.
+        void prepare(double newSampleRate, int maxBlockSize)
+        {
+            sampleRate = newSampleRate;
+            capacity = juce::jmax(1, maxBlockSize);
+
+            if constexpr (Ballistics::isBlockLinear)
+            {
+                decimationFactor = decimationFactorFor(sampleRate);
+                decimatedCapacity = juce::jmax(1, capacity / decimationFactor);
+
+                powers.resize((size_t)capacity + 1);
+                decimatedPowers.resize((size_t)decimatedCapacity + 1);
+                groupSums.resize((size_t)decimatedCapacity);
+
+                setTimeConstant(timeConstantSeconds);
+            }
+            else
+                setAttackRelease(attackSeconds, releaseDbPerSecond);
+
+            reset();
+        }
+
+        // One-pole ballistics only. Safe to call between blocks on the audio thread: it refills
+        // the weight tables prepare() sized, without allocating, at one multiply per entry.
+        void setTimeConstant(double seconds) noexcept
+        {
+            static_assert(Ballistics::isBlockLinear, "Only one-pole ballistics have a single time constant");
+            timeConstantSeconds = seconds;
+
+            const double a = std::exp(-1.0 / (seconds * sampleRate));
+            alpha = (SampleType)a;
+            gain = (SampleType)(1.0 - a);
+
+            // powers[i] = alpha^(capacity - i), i = 0..capacity
+            fillPowers(powers, a);
+
+            // The same table at the decimated rate, where one step is decimationFactor samples.
+            // The gain folds in the box filter's 1/D.
+            const double aD = std::pow(a, (double)decimationFactor);
+            decimatedGain = (SampleType)((1.0 - aD) / (double)decimationFactor);
+            fillPowers(decimatedPowers, aD);
+        }
+
+        // Decimated detection, one-pole ballistics only. The rectified signal is box-filtered
+        // over groups of D = decimationFactorFor(sampleRate) samples and the integrator steps
+        // once per group, at fs / D:
+        //     y_g = a^D * y_(g-1) + (1 - a^D) * mean(rectified group g)
+        // Every group carries the same total weight as its D samples do at full rate, so a steady
+        // level reads identically. Only the timing changes: the samples in a group are weighted
+        // alike, and a block's unfinished group (up to D-1 samples) waits for the next block.
+        // While the level moves, the reading therefore differs from the full-rate one by at
+        // most 1.5 * (D-1) / (fs * tau) of the step. D scales with fs, so for tau = 300 ms that
+        // is about 8e-4 at any rate: under 0.1 dB at the bottom of the VU scale during a rise,
+        // and nothing measurable on steady signals. The coefficients are built with the
+        // full-rate ones, so switching does not allocate; a pending partial group is dropped.
+        void setDecimated(bool shouldDecimate) noexcept
+        {
+            static_assert(Ballistics::isBlockLinear, "Decimated detection needs one-pole ballistics");
+
+            if (shouldDecimate != decimated)
+            {
+                decimated = shouldDecimate;
+                partial.fill(0);
+                groupFill = 0;
+            }
+        }
+
+        bool isDecimated() const noexcept { return decimated; }
+        int getDecimationFactor() const noexcept { return decimationFactor; }
+
+        // Keeps the decimated rate at or above decimatedRateHz: D = 7 at 44.1 kHz, 8 at 48 kHz, 32 at 192 kHz
+        static int decimationFactorFor(double rate) noexcept
+        {
+            return juce::jlimit(1, maxDecimationFactor, (int)(rate / decimatedRateHz));
+        }
+
+        static constexpr double decimatedRateHz = 6000.0;
+        static constexpr int maxDecimationFactor = 64;
+
+        // Attack/release ballistics only.
+        void setAttackRelease(double newAttackSeconds, double newReleaseDbPerSecond) noexcept
+        {
+            static_assert(!Ballistics::isBlockLinear, "One-pole ballistics have no separate attack/release");
+            attackSeconds = newAttackSeconds;
+            releaseDbPerSecond = newReleaseDbPerSecond;
+            attackCoeff = (SampleType)(1.0 - std::exp(-1.0 / (attackSeconds * sampleRate)));
+            releaseCoeff = (SampleType)std::pow(10.0, -releaseDbPerSecond / (20.0 * sampleRate));
+        }
+
+        void reset() noexcept
+        {
+            aggregate = 0;
+            state.fill(0);
+            blockMax.fill(0);
+            partial.fill(0);
+            groupFill = 0;
+        }
+
+        // Processes one block and returns the combined level (linear, after Detector::toLevel).
+        SampleType process(const SampleType* const* channels, int numChannels, int numSamples) noexcept
+        {
+            const int nch = NumChannels == dynamicChannelCount ? juce::jmin(numChannels, maxChannels) : NumChannels;
+            jassert(numChannels >= nch);
+
+            if (nch <= 0 || numSamples <= 0 || capacity == 0)
+                return getLevel();
+
+            if constexpr (Ballistics::isBlockLinear)
+            {
+                if (decimated && decimationFactor > 1)
+                    processDecimated(channels, nch, numSamples);
+                else
+                    processBlockLinear(channels, nch, numSamples);
+            }
+            else
+                processAttackRelease(channels, nch, numSamples);
+
+            return getLevel();
+        }
+
+        // Same as process() on a block of zeros, for a block the caller has already found silent,
+        // but O(channels): the state just decays by alpha^N (or the release over N samples).
+        // Once the combined level and every channel are below floor, the state snaps to exactly
+        // zero, which keeps it out of the denormal range, and the meter reports that it is at rest.
+        bool processSilence(int numChannels, int numSamples, SampleType floor) noexcept
+        {
+            const int nch = NumChannels == dynamicChannelCount ? juce::jmin(numChannels, maxChannels) : NumChannels;
+
+            if (nch > 0 && numSamples > 0 && capacity > 0)
+            {
+                if constexpr (Ballistics::isBlockLinear)
+                {
+                    if (decimated && decimationFactor > 1)
+                        decaySilenceDecimated(nch, numSamples);
+                    else
+                        decayBy(raise(powers, capacity, numSamples), nch);
+                }
+                else
+                {
+                    const SampleType r = releaseCoeff;
+                    const SampleType fall = (SampleType)std::pow((double)r, (double)numSamples);
+
+                    for (int ch = 0; ch < nch; ++ch)
+                    {
+                        const SampleType y = state[(size_t)ch];
+                        state[(size_t)ch] = y * fall;
+                        blockMax[(size_t)ch] = Detector::readsBlockMaximum ? y * r : y * fall;
+                    }
+
+                    combine(nch);
+                }
+            }
+
+            if (Detector::toLevel(aggregate) >= floor)
+                return false;
+
+            for (int ch = 0; ch < nch; ++ch)
+                if (Detector::toLevel(juce::jmax(state[(size_t)ch], blockMax[(size_t)ch])) >= floor)
+                    return false;
+
+            reset();
+            return true;
+        }
+
+        SampleType getLevel() const noexcept { return Detector::toLevel(aggregate); }
+        SampleType getChannelLevel(int ch) const noexcept
+        {
+            return Detector::toLevel(Detector::readsBlockMaximum ? blockMax[(size_t)ch] : state[(size_t)ch]);
+        }
+
+        // Combined level of channels [firstChannel, firstChannel + numChannels), folded the way
+        // getLevel() folds all of them. Lets one process() call meter several buses laid out
+        // side by side in the channel array: they share the pass over the weight table and the
+        // state update, and each still gets its own reading.
+        SampleType getGroupLevel(int firstChannel, int numChannels) const noexcept
+        {
+            const auto& values = Detector::readsBlockMaximum ? blockMax : state;
+            const int begin = juce::jlimit(0, channelCapacity, firstChannel);
+            const int end = juce::jlimit(begin, channelCapacity, firstChannel + numChannels);
+
+            if (end == begin)
+                return 0;
+
+            SampleType combined = 0;
+            for (int ch = begin; ch < end; ++ch)
+                combined = Detector::combinesByMaximum ? juce::jmax(combined, values[(size_t)ch])
+                                                       : combined + values[(size_t)ch];
+
+            return Detector::toLevel(Detector::combinesByMaximum ? combined : combined / (SampleType)(end - begin));
+        }
+
+        SampleType getAlpha() const noexcept { return alpha; }
+        double getTimeConstant() const noexcept { return timeConstantSeconds; }
+
+        // Scalar reference for linear ballistics: the original sample-major loop.
+        static SampleType processReference(SampleType y, SampleType a, const SampleType* const* channels,
+                                           int numChannels, int numSamples) noexcept
+        {
+            for (int n = 0; n < numSamples; ++n)
+            {
+                SampleType mean = 0;
+                for (int ch = 0; ch < numChannels; ++ch)
+                    mean += Detector::rectify(channels[ch][n]);
+                mean /= (SampleType)juce::jmax(1, numChannels);
+                y = a * y + ((SampleType)1 - a) * mean;
+            }
+            return y;
+        }
+
+        // Allowed difference between the block kernel and processReference(), in dB. The
+        // reference loses precision in (1 - alpha) at high sample rates, so this is mostly
+        // the reference's own error.
+        static constexpr double toleranceDb = 0.05;
+
+    private:
+        void processBlockLinear(const SampleType* const* channels, int nch, int numSamples) noexcept
+        {
+           #if JUCE_DEBUG
+            const SampleType reference = processReference(aggregate, alpha, channels, nch, numSamples);
+           #endif
+
+            // Hosts may exceed the prepared block size; fall back to capacity-sized chunks.
+            for (int start = 0; start < numSamples; start += capacity)
+            {
+                const int n = juce::jmin(capacity, numSamples - start);
+                const SampleType* weights = powers.data() + (capacity - n + 1);
+                const SampleType decay = powers[(size_t)(capacity - n)];
+
+                for (int ch = 0; ch < nch; ++ch)
+                    sums[(size_t)ch] = Detector::weightedSum(channels[ch] + start, weights, n);
+
+                integrate(sums.data(), decay, gain, nch);
+            }
+
+           #if JUCE_DEBUG
+            if (reference > (SampleType)1.0e-6)
+                jassert(std::abs(juce::Decibels::gainToDecibels((double)(aggregate / reference))) <= toleranceDb);
+           #endif
+        }
+
+        // See setDecimated(). Not checked against processReference(): the per-block difference
+        // is the timing offset described there, which is large relative to a level near zero.
+        void processDecimated(const SampleType* const* channels, int nch, int numSamples) noexcept
+        {
+            const int d = decimationFactor;
+
+            for (int pos = 0; pos < numSamples;)
+            {
+                // Complete the group the previous block left open, or hold back a short tail
+                if (groupFill > 0 || numSamples - pos < d)
+                {
+                    const int n = juce::jmin(d - groupFill, numSamples - pos);
+                    for (int ch = 0; ch < nch; ++ch)
+                        partial[(size_t)ch] += Detector::sum(channels[ch] + pos, n);
+
+                    pos += n;
+                    groupFill += n;
+
+                    if (groupFill == d)
+                    {
+                        integrate(partial.data(), decimatedPowers[(size_t)(decimatedCapacity - 1)], decimatedGain, nch);
+                        partial.fill(0);
+                        groupFill = 0;
+                    }
+
+                    continue;
+                }
+
+                // Whole groups: box sums, then the closed-form integrator over them. The group
+                // sums are non-negative, so the abs kernel serves as a plain dot product.
+                const int numGroups = juce::jmin(decimatedCapacity, (numSamples - pos) / d);
+                const SampleType* weights = decimatedPowers.data() + (decimatedCapacity - numGroups + 1);
+                const SampleType decay = decimatedPowers[(size_t)(decimatedCapacity - numGroups)];
+
+                for (int ch = 0; ch < nch; ++ch)
+                {
+                    const SampleType* x = channels[ch] + pos;
+                    for (int g = 0; g < numGroups; ++g)
+                        groupSums[(size_t)g] = Detector::sum(x + g * d, d);
+
+                    sums[(size_t)ch] = kernels::weightedAbsSum(groupSums.data(), weights, numGroups);
+                }
+
+                integrate(sums.data(), decay, decimatedGain, nch);
+                pos += numGroups * d;
+            }
+        }
+
+        void decaySilenceDecimated(int nch, int numSamples) noexcept
+        {
+            const int d = decimationFactor;
+            int remaining = numSamples;
+
+            // The open group completes with zeros. A block too short to complete it leaves it
+            // open, with its sum so far, for the next block.
+            if (groupFill > 0)
+            {
+                const int n = juce::jmin(d - groupFill, remaining);
+                groupFill += n;
+                remaining -= n;
+
+                if (groupFill < d)
+                    return;
+
+                integrate(partial.data(), decimatedPowers[(size_t)(decimatedCapacity - 1)], decimatedGain, nch);
+                partial.fill(0);
+                groupFill = 0;
+            }
+
+            // Whole silent groups only decay; the tail opens a group whose sum is still zero
+            decayBy(raise(decimatedPowers, decimatedCapacity, remaining / d), nch);
+            groupFill = remaining % d;
+        }
+
+        // table[i] = base^(size - 1 - i), built from the end as a running product in double
+        // precision: the relative error grows by about one ulp per entry, far below what the
+        // SampleType table can hold.
+        static void fillPowers(std::vector<SampleType>& table, double base) noexcept
+        {
+            double w = 1.0;
+            for (auto i = table.size(); i > 0; --i)
+            {
+                table[i - 1] = (SampleType)w;
+                w *= base;
+            }
+        }
+
+        // table[capacity - k] = base^k for k <= tableCapacity, so any power is a few products
+        static SampleType raise(const std::vector<SampleType>& table, int tableCapacity, int exponent) noexcept
+        {
+            SampleType result = 1;
+            for (; exponent > 0; exponent -= tableCapacity)
+                result *= table[(size_t)(tableCapacity - juce::jmin(exponent, tableCapacity))];
+            return result;
+        }
+
+        void decayBy(SampleType factor, int nch) noexcept
+        {
+            juce::FloatVectorOperations::multiply(state.data(), factor, nch);
+            aggregate *= factor;
+        }
+
+        // y_ch = decay * y_ch + g * values_ch for all channels at once, and the same on the mean
+        void integrate(const SampleType* values, SampleType decay, SampleType g, int nch) noexcept
+        {
+            SampleType sum = 0;
+            for (int ch = 0; ch < nch; ++ch)
+                sum += values[ch];
+
+            juce::FloatVectorOperations::multiply(state.data(), decay, nch);
+            juce::FloatVectorOperations::addWithMultiply(state.data(), values, g, nch);
+
+            aggregate = decay * aggregate + g * sum / (SampleType)nch;
+        }
+
+        void processAttackRelease(const SampleType* const* channels, int nch, int numSamples) noexcept
+        {
+            const SampleType a = attackCoeff;
+            const SampleType r = releaseCoeff;
+
+            for (int ch = 0; ch < nch; ++ch)
+            {
+                const SampleType* x = channels[ch];
+                SampleType y = state[(size_t)ch];
+                SampleType peak = 0;
+
+                for (int i = 0; i < numSamples; ++i)
+                {
+                    const SampleType in = Detector::rectify(x[i]);
+                    const SampleType rising = y + a * (in - y);
+                    const SampleType falling = y * r;
+                    y = in > y ? rising : falling;
+
+                    if constexpr (Detector::readsBlockMaximum)
+                        peak = juce::jmax(peak, y);
+                }
+
+                state[(size_t)ch] = y;
+                blockMax[(size_t)ch] = Detector::readsBlockMaximum ? peak : y;
+            }
+
+            combine(nch);
+        }
+
+        // Attack/release: the per-channel readings folded into aggregate
+        void combine(int nch) noexcept
+        {
+            const auto& values = Detector::readsBlockMaximum ? blockMax : state;
+            SampleType combined = 0;
+            for (int ch = 0; ch < nch; ++ch)
+                combined = Detector::combinesByMaximum ? juce::jmax(combined, values[(size_t)ch])
+                                                       : combined + values[(size_t)ch];
+
+            aggregate = Detector::combinesByMaximum ? combined : combined / (SampleType)nch;
+        }
+
+        double sampleRate = 44100.0;
+        int capacity = 0;
+
+        // One-pole
+        double timeConstantSeconds = [] { if constexpr (Ballistics::isBlockLinear) return Ballistics::timeConstantSeconds; else return 0.0; }();
+        SampleType alpha = 0;                               // per-sample smoothing coeff
+        SampleType gain = 0;                                // 1 - alpha, computed in double precision
+        std::vector<SampleType> powers;                     // alpha^k table, see setTimeConstant()
+
+        // Decimated one-pole, see setDecimated()
+        bool decimated = false;
+        int decimationFactor = 1;
+        int decimatedCapacity = 0;                          // whole groups per chunk
+        SampleType decimatedGain = 0;                       // (1 - alpha^D) / D
+        std::vector<SampleType> decimatedPowers;            // (alpha^D)^k table
+        std::vector<SampleType> groupSums;                  // box sums of the channel being processed
+        int groupFill = 0;                                  // samples in the open group
+
+        // Attack/release
+        double attackSeconds = [] { if constexpr (!Ballistics::isBlockLinear) return Ballistics::attackSeconds; else return 0.0; }();
+        double releaseDbPerSecond = [] { if constexpr (!Ballistics::isBlockLinear) return Ballistics::releaseDbPerSecond; else return 0.0; }();
+        SampleType attackCoeff = 0;
+        SampleType releaseCoeff = 0;
+
+        // Per-channel state, structure of arrays
+        SampleType aggregate = 0;                           // combined over channels
+        alignas(16) std::array<SampleType, channelCapacity> state {};
+        alignas(16) std::array<SampleType, channelCapacity> sums {};
+        alignas(16) std::array<SampleType, channelCapacity> blockMax {};
+        alignas(16) std::array<SampleType, channelCapacity> partial {};     // open group, per channel
+
+        JUCE_DECLARE_NON_COPYABLE(Meter)
+    };
+}
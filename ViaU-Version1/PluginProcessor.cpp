@@ -10,15 +10,13 @@ ViaUAudioProcessor::ViaUAudioProcessor()
 {
 }
 
-void ViaUAudioProcessor::prepareToPlay(double sampleRate, int /*samplesPerBlock*/)
+void ViaUAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
     fs = sampleRate;
 
-    // 300 ms VU integration time constant (single-pole low-pass on rectified signal)
-    const double tau = 0.300; // seconds
-    alpha = (float)std::exp(-1.0 / (tau * fs));
-
-    vuIntegrator = 0.0f;
+    // 300 ms VU integration time constant (single-pole low-pass on rectified signal),
+    // see viau::VUBallistics
+    detector.prepare(fs, samplesPerBlock);
     currentVU.store(-20.0f);
 }
 
@@ -50,17 +48,9 @@ void ViaUAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::Mi
 
     // Compute rectified absolute signal averaged across channels
     // and integrate with ~300 ms time constant for classic VU ballistics.
-    for (int n = 0; n < numSamples; ++n)
-    {
-        float sampleAbsMean = 0.0f;
-        for (int ch = 0; ch < numCh; ++ch)
-            sampleAbsMean += std::abs(buffer.getReadPointer(ch)[n]);
-
-        sampleAbsMean /= (float)juce::jmax(1, numCh);
-
-        // Single-pole IIR: y[n] = alpha*y[n-1] + (1-alpha)*x[n]
-        vuIntegrator = alpha * vuIntegrator + (1.0f - alpha) * sampleAbsMean;
-    }
+    // Single-pole IIR: y[n] = alpha*y[n-1] + (1-alpha)*x[n], evaluated per block
+    // over each channel in turn (see MeteringCore.h).
+    const float vuIntegrator = detector.process(buffer.getArrayOfReadPointers(), numCh, numSamples);
 
     // Convert to dBFS for reference mapping.
     // Add a tiny epsilon to avoid log of zero.
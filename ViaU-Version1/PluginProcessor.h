@@ -1,6 +1,7 @@
 #pragma once
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <atomic>
+#include "../ViaU-Common/MeteringCore.h"
 
 class ViaUAudioProcessor : public juce::AudioProcessor
 {
@@ -50,8 +51,7 @@ public:
 private:
     // VU integration
     double fs = 44100.0;
-    float vuIntegrator = 0.0f;          // internal smoothed value (linear)
-    float alpha = 0.0f;                 // per-sample smoothing coeff from 300 ms time constant
+    viau::Meter<viau::AbsDetector, viau::VUBallistics> detector; // rectifier + 300 ms integrator
     std::atomic<float> currentVU{ -20.0f }; // exposed VU value in VU units (-20..+3)
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ViaUAudioProcessor)
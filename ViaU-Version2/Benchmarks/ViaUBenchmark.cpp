@@ -0,0 +1,322 @@
+// Headless benchmark for ViaUAudioProcessor::processBlock, ViaUAudioProcessorEditor::paint and
+// the plugin state save/load.
+//
+// Build as a JUCE console application together with ../Source/*.cpp (same modules and
+// JucePlugin_* definitions as the plugin target). Usage:
+//
+//   ViaUBenchmark [--quick] [--baseline <file>] [--write-baseline <file>] [--tolerance <percent>]
+//
+// Every measurement is printed as "<key> <value>". With --baseline, each key found in the
+// baseline file is compared against the current run and the process exits with code 1 if any
+// result is slower than the baseline by more than the tolerance (default 20 %). A baseline
+// with no result for this run (none recorded on this machine yet) exits with code 77, which
+// the CMake build's regression test reports as skipped.
+
+#include "../Source/PluginProcessor.h"
+#include "../Source/PluginEditor.h"
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <random>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    constexpr int noBaselineExitCode = 77;      // ctest's SKIP_RETURN_CODE
+
+    struct Result
+    {
+        juce::String key;
+        double value = 0.0;     // lower is better
+        juce::String unit;
+    };
+
+    double secondsSince(Clock::time_point start)
+    {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    //==============================================================================
+    // processBlock: ns per sample (per channel) for every combination below.
+    void benchmarkProcessBlock(std::vector<Result>& results, bool quick)
+    {
+        const double sampleRates[] = { 44100.0, 48000.0, 96000.0, 192000.0 };
+        const int blockSizes[] = { 16, 32, 64, 128, 256, 512, 1024, 2048, 4096 };
+        const int channelCounts[] = { 1, 2, 6, 12, 64 }; // mono, stereo, 5.1, 7.1.4, 7th-order ambisonic
+        const double secondsOfAudio = quick ? 2.0 : 20.0;
+
+        std::mt19937 rng(0x5eed);
+        std::uniform_real_distribution<float> dist(-0.5f, 0.5f);
+
+        // Full-rate keys keep their original names so existing baselines still apply
+        for (auto decimated : { false, true })
+        {
+            const juce::String prefix = decimated ? "process-decimated/" : "process/";
+
+            for (auto sampleRate : sampleRates)
+            {
+                for (auto numChannels : channelCounts)
+                {
+                    for (auto blockSize : blockSizes)
+                    {
+                        ViaUAudioProcessor processor;
+                        processor.setPlayConfigDetails(numChannels, numChannels, sampleRate, blockSize);
+                        processor.prepareToPlay(sampleRate, blockSize);
+                        processor.apvts.getParameter("decimated")->setValueNotifyingHost(decimated ? 1.0f : 0.0f);
+
+                        juce::AudioBuffer<float> buffer(numChannels, blockSize);
+                        for (int ch = 0; ch < numChannels; ++ch)
+                            for (int n = 0; n < blockSize; ++n)
+                                buffer.setSample(ch, n, dist(rng));
+
+                        juce::MidiBuffer midi;
+                        const int numBlocks = juce::jmax(16, (int)(secondsOfAudio * sampleRate / blockSize));
+
+                        // Warm up caches and branch predictors
+                        for (int i = 0; i < 8; ++i)
+                            processor.processBlock(buffer, midi);
+
+                        const auto start = Clock::now();
+                        for (int i = 0; i < numBlocks; ++i)
+                            processor.processBlock(buffer, midi);
+                        const double elapsed = secondsSince(start);
+
+                        const double nsPerSample = elapsed * 1.0e9 / ((double)numBlocks * blockSize * numChannels);
+                        results.push_back({ prefix + juce::String((int)sampleRate) + "/" + juce::String(numChannels)
+                                                + "ch/" + juce::String(blockSize),
+                                            nsPerSample, "ns/sample" });
+
+                        processor.releaseResources();
+                    }
+                }
+            }
+        }
+    }
+
+    //==============================================================================
+    // paint: ms per frame for each display mode, editor size and pixel scale.
+    void benchmarkPaint(std::vector<Result>& results, bool quick)
+    {
+        struct Size { int w, h; };
+        const Size sizes[] = { { 360, 180 }, { 720, 360 }, { 1440, 720 } };
+        const float scales[] = { 1.0f, 2.0f };
+        const int numFrames = quick ? 30 : 300;
+
+        ViaUAudioProcessor processor;
+        processor.prepareToPlay(48000.0, 512);
+        std::unique_ptr<juce::AudioProcessorEditor> editor(processor.createEditor());
+        editor->setVisible(true);
+
+        // Every display mode the parameter offers, keyed by its lower-case name ("led", "needle", ...)
+        auto* modeParam = processor.apvts.getParameter("displayMode");
+        juce::StringArray modeNames;
+        if (auto* choice = dynamic_cast<juce::AudioParameterChoice*>(modeParam))
+            for (auto& name : choice->choices)
+                modeNames.add(name.toLowerCase());
+
+        for (int mode = 0; mode < modeNames.size(); ++mode)
+        {
+            modeParam->setValueNotifyingHost(modeParam->convertTo0to1((float)mode));
+
+            for (auto size : sizes)
+            {
+                editor->setSize(size.w, size.h);
+
+                for (auto scale : scales)
+                {
+                    juce::Image image(juce::Image::ARGB, juce::roundToInt(size.w * scale),
+                                      juce::roundToInt(size.h * scale), true);
+
+                    auto renderFrame = [&]
+                        {
+                            juce::Graphics g(image);
+                            g.addTransform(juce::AffineTransform::scale(scale));
+                            editor->paintEntireComponent(g, true);
+                        };
+
+                    renderFrame(); // warm up
+
+                    const auto start = Clock::now();
+                    for (int i = 0; i < numFrames; ++i)
+                        renderFrame();
+                    const double msPerFrame = secondsSince(start) * 1000.0 / numFrames;
+
+                    results.push_back({ "paint/" + modeNames[mode] + "/" + juce::String(size.w) + "x"
+                                            + juce::String(size.h) + "@" + juce::String(scale, 0) + "x",
+                                        msPerFrame, "ms/frame" });
+                }
+            }
+        }
+    }
+
+    //==============================================================================
+    // Session save/load: us per instance, for the binary state and for the XML state written
+    // by earlier builds (which setStateInformation still reads). Loading goes round a set of
+    // instances, as a host does when it opens a project.
+    void benchmarkState(std::vector<Result>& results, bool quick)
+    {
+        const int numInstances = quick ? 32 : 256;
+        const int numRounds = quick ? 20 : 200;
+
+        std::vector<std::unique_ptr<ViaUAudioProcessor>> instances;
+        for (int i = 0; i < numInstances; ++i)
+            instances.push_back(std::make_unique<ViaUAudioProcessor>());
+
+        // A state away from the defaults, so every parameter is written and applied. Recording
+        // and the dashboard export stay off; they would start writing files and shared memory.
+        auto& source = *instances.front();
+        std::mt19937 rng(0x5eed);
+        std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+        for (auto* parameter : source.getParameters())
+            if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter))
+                if (ranged->getParameterID() != "record" && ranged->getParameterID() != "export")
+                    ranged->setValueNotifyingHost(dist(rng));
+
+        auto saveXml = [](ViaUAudioProcessor& processor, juce::MemoryBlock& dest)
+            {
+                if (auto xml = processor.apvts.copyState().createXml())
+                    juce::AudioProcessor::copyXmlToBinary(*xml, dest);
+            };
+
+        juce::MemoryBlock binaryState, xmlState;
+        source.getStateInformation(binaryState);
+        saveXml(source, xmlState);
+
+        auto measure = [&](const juce::String& key, auto&& perInstance)
+            {
+                for (auto& instance : instances)
+                    perInstance(*instance); // warm up
+
+                const auto start = Clock::now();
+                for (int round = 0; round < numRounds; ++round)
+                    for (auto& instance : instances)
+                        perInstance(*instance);
+                const double usPerInstance = secondsSince(start) * 1.0e6 / ((double)numRounds * numInstances);
+
+                results.push_back({ key, usPerInstance, "us/instance" });
+            };
+
+        juce::MemoryBlock scratch;
+        measure("state/save-binary", [&](ViaUAudioProcessor& p) { p.getStateInformation(scratch); });
+        measure("state/save-xml", [&](ViaUAudioProcessor& p) { saveXml(p, scratch); });
+
+        // Alternate with the default state so every load really changes the parameters
+        juce::MemoryBlock defaultBinary, defaultXml;
+        instances.back()->getStateInformation(defaultBinary);
+        saveXml(*instances.back(), defaultXml);
+
+        bool flip = false;
+        measure("state/load-binary", [&](ViaUAudioProcessor& p)
+            {
+                const auto& state = (flip = !flip) ? binaryState : defaultBinary;
+                p.setStateInformation(state.getData(), (int)state.getSize());
+            });
+        measure("state/load-xml", [&](ViaUAudioProcessor& p)
+            {
+                const auto& state = (flip = !flip) ? xmlState : defaultXml;
+                p.setStateInformation(state.getData(), (int)state.getSize());
+            });
+
+        results.push_back({ "state/size-binary", (double)binaryState.getSize(), "bytes" });
+        results.push_back({ "state/size-xml", (double)xmlState.getSize(), "bytes" });
+    }
+
+    //==============================================================================
+    std::map<juce::String, double> readBaseline(const juce::File& file)
+    {
+        std::map<juce::String, double> baseline;
+        juce::StringArray lines;
+        file.readLines(lines);
+
+        for (auto& line : lines)
+        {
+            auto tokens = juce::StringArray::fromTokens(line.trim(), " \t", {});
+            if (tokens.size() >= 2 && !tokens[0].startsWith("#"))
+                baseline[tokens[0]] = tokens[1].getDoubleValue();
+        }
+
+        return baseline;
+    }
+
+    void writeBaseline(const juce::File& file, const std::vector<Result>& results)
+    {
+        juce::String text;
+        text << "# ViaUBenchmark baseline (" << juce::SystemStats::getCpuModel() << ")\n";
+        for (auto& r : results)
+            text << r.key << " " << juce::String(r.value, 4) << " " << r.unit << "\n";
+        file.replaceWithText(text);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;
+    juce::ArgumentList args(argc, argv);
+
+    return juce::ConsoleApplication::invokeCatchingFailures([&]
+        {
+            const bool quick = args.containsOption("--quick");
+            const double tolerance = args.containsOption("--tolerance")
+                ? args.getValueForOption("--tolerance").getDoubleValue() / 100.0
+                : 0.20;
+
+            std::vector<Result> results;
+            benchmarkProcessBlock(results, quick);
+            benchmarkPaint(results, quick);
+            benchmarkState(results, quick);
+
+            for (auto& r : results)
+                std::cout << r.key << " " << juce::String(r.value, 4) << " " << r.unit << std::endl;
+
+            if (args.containsOption("--write-baseline"))
+            {
+                auto file = args.getFileForOption("--write-baseline");
+                writeBaseline(file, results);
+                std::cout << "Wrote baseline to " << file.getFullPathName() << std::endl;
+            }
+
+            if (!args.containsOption("--baseline"))
+                return 0;
+
+            const auto baselineFile = args.getExistingFileForOption("--baseline");
+            const auto baseline = readBaseline(baselineFile);
+            int regressions = 0, numCompared = 0;
+
+            for (auto& r : results)
+            {
+                auto it = baseline.find(r.key);
+                if (it == baseline.end() || it->second <= 0.0)
+                    continue;
+
+                ++numCompared;
+
+                const double ratio = r.value / it->second;
+                if (ratio > 1.0 + tolerance)
+                {
+                    std::cout << "REGRESSION " << r.key << ": " << juce::String(r.value, 4) << " " << r.unit
+                              << " vs baseline " << juce::String(it->second, 4)
+                              << " (+" << juce::String((ratio - 1.0) * 100.0, 1) << " %)" << std::endl;
+                    ++regressions;
+                }
+            }
+
+            // Nothing to compare against is not a pass: report it as skipped
+            if (numCompared == 0)
+            {
+                std::cout << baselineFile.getFullPathName() << " has no results for this run; record one with "
+                          << (quick ? "--quick " : "") << "--write-baseline" << std::endl;
+                return noBaselineExitCode;
+            }
+
+            if (regressions > 0)
+            {
+                std::cout << regressions << " result(s) regressed beyond " << juce::String(tolerance * 100.0, 0)
+                          << " %" << std::endl;
+                return 1;
+            }
+
+            std::cout << "No regressions in " << numCompared << " result(s) against baseline" << std::endl;
+            return 0;
+        });
+}
@@ -0,0 +1,298 @@
+// Multi-instance scaling harness: N ViaUAudioProcessor instances driven by a simulated host
+// graph, to see how throughput and cycle latency hold up across cores as N grows.
+//
+// Build as a JUCE console application together with ../Source/*.cpp (same modules and
+// JucePlugin_* definitions as the plugin target). Usage:
+//
+//   ViaUScalingHarness [--quick] [--instances <n,n,...>] [--threads <max>] [--block <samples>]
+//                      [--rate <Hz>] [--channels <n>] [--seconds <audio seconds per run>]
+//                      [--analysers]
+//
+// The graph is what a host builds for a session of parallel tracks: every instance is a node
+// with its own buffers, the nodes of a cycle are shared out between the host's audio threads,
+// and the outputs are summed into a master bus once all of them are done. Each cycle is timed
+// from the start of the first node to the end of the master sum, which is the latency a host
+// has to fit into its buffer period.
+//
+// For every instance count the run is repeated with 1, 2, 4, ... host threads up to --threads
+// (default: all cores). Results are printed as "<key> <value> <unit>", as by ViaUBenchmark:
+//
+//   scaling/<N>x/<T>t/per-instance    mean cycle time / N                          ns/block
+//   scaling/<N>x/<T>t/p50, p99, p999, max   cycle time percentiles                us
+//   scaling/<N>x/<T>t/load            mean cycle time as a share of the period     %
+//   scaling/<N>x/<T>t/overruns        cycles longer than the period                %
+//   scaling/<N>x/<T>t/speedup         throughput against the 1-thread run          x
+//
+// By default every analyser is off, as in a session that only uses the VU meters: the
+// instances queue nothing for analysis and the shared analysis threads are never woken, so
+// the numbers are the audio threads' own. --analysers adds a second pass with true peak and
+// loudness on, reported under scaling/analysers/..., in which the host threads share the
+// machine with the shared analysis threads (see AnalysisThreadPool.h).
+
+#include "../Source/PluginProcessor.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <thread>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    struct Settings
+    {
+        std::vector<int> instanceCounts { 1, 8, 32, 128, 512 };
+        int maxThreads = 1;
+        int blockSize = 512;
+        double sampleRate = 48000.0;
+        int numChannels = 2;
+        double seconds = 5.0;
+        bool analysers = false;                                  // this pass
+    };
+
+    //==============================================================================
+    // The simulated host graph. Host threads claim nodes from a shared cursor holding
+    // (cycle << 32 | next node): a thread that read the cursor during an earlier cycle fails its
+    // compare-exchange instead of claiming a node of the next one.
+    class HostGraph
+    {
+    public:
+        HostGraph(int numNodes, const Settings& s)
+            : settings(s), master(s.numChannels, s.blockSize)
+        {
+            std::mt19937 rng(0x5eed);
+            std::uniform_real_distribution<float> dist(-0.5f, 0.5f);
+
+            for (int i = 0; i < numNodes; ++i)
+            {
+                auto node = std::make_unique<Node>();
+                for (auto* id : { "truePeak", "loudness" })
+                    node->processor.apvts.getParameter(id)->setValueNotifyingHost(s.analysers ? 1.0f : 0.0f);
+
+                node->processor.setPlayConfigDetails(s.numChannels, s.numChannels, s.sampleRate, s.blockSize);
+                node->processor.prepareToPlay(s.sampleRate, s.blockSize);
+                node->buffer.setSize(s.numChannels, s.blockSize);
+
+                for (int ch = 0; ch < s.numChannels; ++ch)
+                    for (int n = 0; n < s.blockSize; ++n)
+                        node->buffer.setSample(ch, n, dist(rng));
+
+                nodes.push_back(std::move(node));
+            }
+        }
+
+        ~HostGraph()
+        {
+            for (auto& node : nodes)
+                node->processor.releaseResources();
+        }
+
+        // Runs numCycles cycles on numThreads host threads (the calling thread being one of
+        // them) and returns the time of each cycle in seconds.
+        std::vector<double> run(int numThreads, int numCycles)
+        {
+            std::atomic<bool> stop { false };
+            std::vector<std::thread> helpers;
+
+            for (int i = 1; i < numThreads; ++i)
+                helpers.emplace_back([this, &stop]
+                    {
+                        // Host audio threads spin between cycles rather than sleep
+                        while (!stop.load(std::memory_order_relaxed))
+                            if (!processNextNode())
+                                std::this_thread::yield();
+                    });
+
+            for (int i = 0; i < 8; ++i)
+                runCycle(); // warm up caches and branch predictors
+
+            std::vector<double> cycleTimes;
+            cycleTimes.reserve((size_t)numCycles);
+
+            for (int i = 0; i < numCycles; ++i)
+            {
+                const auto start = Clock::now();
+                runCycle();
+                cycleTimes.push_back(std::chrono::duration<double>(Clock::now() - start).count());
+            }
+
+            stop.store(true);
+            for (auto& helper : helpers)
+                helper.join();
+
+            return cycleTimes;
+        }
+
+    private:
+        struct Node
+        {
+            ViaUAudioProcessor processor;
+            juce::AudioBuffer<float> buffer;
+            juce::MidiBuffer midi;
+        };
+
+        void runCycle()
+        {
+            // Every node of the previous cycle has been claimed and finished by now
+            nodesDone.store(0, std::memory_order_relaxed);
+            cursor.store(++cycle << 32, std::memory_order_release);
+
+            while (processNextNode())
+                ;
+
+            while (nodesDone.load(std::memory_order_acquire) < nodes.size())
+                std::this_thread::yield();
+
+            master.clear();
+            for (auto& node : nodes)
+                for (int ch = 0; ch < settings.numChannels; ++ch)
+                    master.addFrom(ch, 0, node->buffer, ch, 0, settings.blockSize);
+        }
+
+        bool processNextNode()
+        {
+            auto current = cursor.load(std::memory_order_acquire);
+
+            for (;;)
+            {
+                const auto index = (size_t)(current & 0xffffffffu);
+                if (index >= nodes.size())
+                    return false;
+
+                if (cursor.compare_exchange_weak(current, current + 1, std::memory_order_acq_rel))
+                {
+                    auto& node = *nodes[index];
+                    node.processor.processBlock(node.buffer, node.midi);
+                    nodesDone.fetch_add(1, std::memory_order_release);
+                    return true;
+                }
+            }
+        }
+
+        const Settings& settings;
+        std::vector<std::unique_ptr<Node>> nodes;
+        juce::AudioBuffer<float> master;
+        std::uint64_t cycle = 0;                                  // calling thread only
+
+        // Claimed by every host thread; starts past the last node, so nothing runs before the first cycle
+        alignas(64) std::atomic<std::uint64_t> cursor { 0xffffffffu };
+        alignas(64) std::atomic<size_t> nodesDone { 0 };
+    };
+
+    //==============================================================================
+    double percentile(const std::vector<double>& sorted, double fraction)
+    {
+        const auto index = (size_t)std::ceil(fraction * (double)sorted.size());
+        return sorted[juce::jlimit((size_t)0, sorted.size() - 1, index > 0 ? index - 1 : 0)];
+    }
+
+    std::vector<int> parseList(const juce::String& text)
+    {
+        std::vector<int> values;
+        for (auto& token : juce::StringArray::fromTokens(text, ",", {}))
+            if (token.trim().getIntValue() > 0)
+                values.push_back(token.trim().getIntValue());
+        return values;
+    }
+
+    void print(const juce::String& key, double value, const juce::String& unit)
+    {
+        std::cout << key << " " << juce::String(value, 4) << " " << unit << std::endl;
+    }
+
+    void runScaling(const Settings& s)
+    {
+        const double period = s.blockSize / s.sampleRate;
+        const int numCycles = juce::jmax(64, (int)(s.seconds / period));
+
+        std::vector<int> threadCounts;
+        for (int t = 1; t < s.maxThreads; t *= 2)
+            threadCounts.push_back(t);
+        threadCounts.push_back(s.maxThreads);
+
+        for (auto numInstances : s.instanceCounts)
+        {
+            HostGraph graph(numInstances, s);
+            double singleThreadMean = 0.0;
+
+            for (auto numThreads : threadCounts)
+            {
+                auto times = graph.run(numThreads, numCycles);
+                std::sort(times.begin(), times.end());
+
+                double total = 0.0;
+                for (auto t : times)
+                    total += t;
+                const double mean = total / (double)times.size();
+
+                if (numThreads == 1)
+                    singleThreadMean = mean;
+
+                const auto overruns = times.end() - std::upper_bound(times.begin(), times.end(), period);
+                const juce::String prefix = juce::String(s.analysers ? "scaling/analysers/" : "scaling/") + juce::String(numInstances) + "x/" + juce::String(numThreads) + "t/";
+
+                print(prefix + "per-instance", mean * 1.0e9 / numInstances, "ns/block");
+                print(prefix + "p50", percentile(times, 0.50) * 1.0e6, "us");
+                print(prefix + "p99", percentile(times, 0.99) * 1.0e6, "us");
+                print(prefix + "p999", percentile(times, 0.999) * 1.0e6, "us");
+                print(prefix + "max", times.back() * 1.0e6, "us");
+                print(prefix + "load", mean / period * 100.0, "%");
+                print(prefix + "overruns", (double)overruns * 100.0 / (double)times.size(), "%");
+                print(prefix + "speedup", singleThreadMean / mean, "x");
+            }
+        }
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;
+    juce::ArgumentList args(argc, argv);
+
+    return juce::ConsoleApplication::invokeCatchingFailures([&]
+        {
+            Settings s;
+            const bool quick = args.containsOption("--quick");
+
+            if (quick)
+            {
+                s.instanceCounts = { 1, 8, 64 };
+                s.seconds = 1.0;
+            }
+
+            s.maxThreads = juce::jmax(1, (int)std::thread::hardware_concurrency());
+
+            if (args.containsOption("--instances"))
+                s.instanceCounts = parseList(args.getValueForOption("--instances"));
+            if (args.containsOption("--threads"))
+                s.maxThreads = juce::jmax(1, args.getValueForOption("--threads").getIntValue());
+            if (args.containsOption("--block"))
+                s.blockSize = juce::jlimit(16, 8192, args.getValueForOption("--block").getIntValue());
+            if (args.containsOption("--rate"))
+                s.sampleRate = juce::jlimit(8000.0, 768000.0, args.getValueForOption("--rate").getDoubleValue());
+            if (args.containsOption("--channels"))
+                s.numChannels = juce::jlimit(1, 64, args.getValueForOption("--channels").getIntValue());
+            if (args.containsOption("--seconds"))
+                s.seconds = juce::jmax(0.1, args.getValueForOption("--seconds").getDoubleValue());
+
+            if (s.instanceCounts.empty())
+                juce::ConsoleApplication::fail("--instances needs a comma-separated list of counts");
+
+            std::cout << "# " << juce::SystemStats::getCpuModel() << ", " << s.maxThreads << " host threads max, "
+                      << s.blockSize << " samples at " << juce::String(s.sampleRate, 0) << " Hz, "
+                      << s.numChannels << " ch" << std::endl;
+
+            runScaling(s);
+
+            if (args.containsOption("--analysers"))
+            {
+                s.analysers = true;
+                runScaling(s);
+            }
+
+            return 0;
+        });
+}
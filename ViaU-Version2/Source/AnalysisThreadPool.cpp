@@ -0,0 +1,79 @@
+#include "AnalysisThreadPool.h"
+#include <limits>
+
+AnalysisThreadPool::AnalysisThreadPool()
+{
+    const int numThreads = juce::jlimit(1, maxThreads, juce::SystemStats::getNumCpus() / 2);
+    for (int i = 0; i < numThreads; ++i)
+        shards.add(new Shard(i));
+}
+
+// Every worker has removed its job by now; each shard stops its thread as it is deleted
+AnalysisThreadPool::~AnalysisThreadPool() = default;
+
+int AnalysisThreadPool::add(Job& job)
+{
+    int index = 0, fewest = std::numeric_limits<int>::max();
+    for (int i = 0; i < shards.size(); ++i)
+    {
+        const juce::ScopedLock sl(shards[i]->lock);
+        if (shards[i]->jobs.size() < fewest)
+        {
+            fewest = shards[i]->jobs.size();
+            index = i;
+        }
+    }
+
+    auto* shard = shards[index];
+    {
+        const juce::ScopedLock sl(shard->lock);
+        shard->jobs.addIfNotAlreadyThere(&job);
+    }
+
+    if (!shard->isThreadRunning())
+        shard->startThread();
+
+    return index;
+}
+
+void AnalysisThreadPool::remove(Job& job, int shard)
+{
+    if (auto* s = shards[shard])
+    {
+        const juce::ScopedLock sl(s->lock);
+        s->jobs.removeFirstMatchingValue(&job);
+    }
+}
+
+void AnalysisThreadPool::notify(int shard) noexcept
+{
+    // The thread clears awake before it looks at its jobs, so work queued after that is seen
+    // either by the running pass or, through this signal, by the next one
+    auto* s = shards.getUnchecked(shard);
+    if (!s->awake.exchange(true))
+        s->notify();
+}
+
+//==============================================================================
+AnalysisThreadPool::Shard::Shard(int index)
+    : juce::Thread("ViaU analysis " + juce::String(index + 1))
+{
+}
+
+AnalysisThreadPool::Shard::~Shard()
+{
+    stopThread(2000);
+}
+
+void AnalysisThreadPool::Shard::run()
+{
+    while (!threadShouldExit())
+    {
+        wait(-1);
+        awake.store(false);
+
+        const juce::ScopedLock sl(lock);
+        for (auto* job : jobs)
+            job->drain();
+    }
+}
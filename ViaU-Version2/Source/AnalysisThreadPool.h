@@ -0,0 +1,57 @@
+#pragma once
+#include <juce_core/juce_core.h>
+#include <atomic>
+
+// Process-wide threads that drain every instance's AnalysisWorker.
+//
+// Held through juce::SharedResourcePointer, so all plugin instances in a process share one
+// small set of threads (half the cores, at most maxThreads) instead of one thread each. Every
+// job is pinned to one shard, so a job is only ever drained by one thread and its client needs
+// no locking; jobs go to the shard with the fewest, and a shard's thread starts with its first
+// job. The threads sleep until an audio thread calls notify(); nothing polls, so a session
+// whose analysers are all off costs no wake-ups at all.
+class AnalysisThreadPool
+{
+public:
+    struct Job
+    {
+        virtual ~Job() = default;
+
+        // Pool thread: take everything queued and analyse it
+        virtual void drain() = 0;
+    };
+
+    static constexpr int maxThreads = 8;
+
+    AnalysisThreadPool();
+    ~AnalysisThreadPool();
+
+    // While the job's audio thread is stopped. add() returns the shard to notify; remove()
+    // waits for a drain of the job in progress to finish.
+    int add(Job& job);
+    void remove(Job& job, int shard);
+
+    // Audio thread. Wakes the shard's thread unless it is already awake; lock-free then, and
+    // otherwise the brief signal of juce::Thread::notify().
+    void notify(int shard) noexcept;
+
+    int getNumThreads() const noexcept { return shards.size(); }
+
+private:
+    class Shard : public juce::Thread
+    {
+    public:
+        explicit Shard(int index);
+        ~Shard() override;
+
+        void run() override;
+
+        juce::CriticalSection lock;                     // held while draining; guards jobs
+        juce::Array<Job*> jobs;
+        std::atomic<bool> awake{ false };
+    };
+
+    juce::OwnedArray<Shard> shards;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AnalysisThreadPool)
+};
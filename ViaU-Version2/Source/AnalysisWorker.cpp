@@ -0,0 +1,186 @@
+#include "AnalysisWorker.h"
+#include <utility>
+
+AnalysisWorker::AnalysisWorker(Client& clientToUse)
+    : client(clientToUse),
+      pending((size_t)maxBlocks)
+{
+}
+
+AnalysisWorker::~AnalysisWorker()
+{
+    release();
+}
+
+void AnalysisWorker::prepare(double sampleRate, int maxBlockSize, int numChannels)
+{
+    release();
+
+    // Capacity - 1 samples fit, so a single maximum-size block always does
+    const int capacity = juce::jmax(maxBlockSize * 8, (int)(sampleRate * ringSeconds)) + 1;
+    const int ringChannels = juce::jlimit(1, maxChannels, numChannels);
+
+    ring.setSize(ringChannels, capacity);
+    sampleFifo.setTotalSize(capacity);
+    blockFifo.reset();
+    zeros.setSize(ringChannels, silenceChunk);
+    zeros.clear();
+    numDropped.store(0, std::memory_order_relaxed);
+
+    notifyIntervalSamples = juce::jmax(1, (int)(sampleRate * notifyIntervalMs / 1000.0));
+    samplesSinceNotify = 0;
+    skipped = false;
+
+    shard = pool->add(*this);
+}
+
+void AnalysisWorker::release()
+{
+    if (shard >= 0)
+        pool->remove(*this, shard);
+
+    shard = -1;
+}
+
+void AnalysisWorker::push(const float* const* channels, int numChannels, int numSamples) noexcept
+{
+    pushChannels(channels, numChannels, numSamples);
+}
+
+void AnalysisWorker::push(const double* const* channels, int numChannels, int numSamples) noexcept
+{
+    pushChannels(channels, numChannels, numSamples);
+}
+
+template <typename SampleType>
+void AnalysisWorker::pushChannels(const SampleType* const* channels, int numChannels, int numSamples) noexcept
+{
+    numChannels = juce::jmin(numChannels, ring.getNumChannels());
+
+    // Both rings need room before anything is written; a block is queued whole or not at all.
+    // Unprepared, the rings are not even sized (see pushBlock()).
+    if (shard < 0 || blockFifo.getFreeSpace() < 1 || sampleFifo.getFreeSpace() < numSamples)
+    {
+        numDropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    int start1, size1, start2, size2;
+    sampleFifo.prepareToWrite(numSamples, start1, size1, start2, size2);
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        const auto* src = channels[ch];
+        auto* dest = ring.getWritePointer(ch);
+
+        if constexpr (std::is_same<SampleType, float>::value)
+        {
+            juce::FloatVectorOperations::copy(dest + start1, src, size1);
+            juce::FloatVectorOperations::copy(dest + start2, src + size1, size2);
+        }
+        else
+        {
+            std::copy(src, src + size1, dest + start1);
+            std::copy(src + size1, src + size1 + size2, dest + start2);
+        }
+    }
+
+    // Samples first: once the worker sees the block, its samples are there too
+    sampleFifo.finishedWrite(size1 + size2);
+    pushBlock({ numSamples, numChannels, false });
+}
+
+void AnalysisWorker::pushSilence(int numChannels, int numSamples) noexcept
+{
+    if (!pushBlock({ numSamples, juce::jmin(numChannels, ring.getNumChannels()), true }))
+        numDropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool AnalysisWorker::pushBlock(Block block) noexcept
+{
+    // Not prepared (a host calling processBlock outside prepareToPlay/releaseResources): there
+    // is no shard to wake, and nothing would drain the block
+    if (shard < 0)
+        return false;
+
+    int start1, size1, start2, size2;
+    blockFifo.prepareToWrite(1, start1, size1, start2, size2);
+
+    if (size1 + size2 == 0)
+        return false;
+
+    block.resumed = std::exchange(skipped, false);
+    blocks[(size_t)(size1 > 0 ? start1 : start2)] = block;
+    blockFifo.finishedWrite(1);
+
+    // Wake the pool about every notifyIntervalMs of audio, rather than once per block
+    samplesSinceNotify += block.numSamples;
+    if (samplesSinceNotify >= notifyIntervalSamples)
+    {
+        samplesSinceNotify = 0;
+        pool->notify(shard);
+    }
+
+    return true;
+}
+
+void AnalysisWorker::drain()
+{
+    int start1, size1, start2, size2;
+    blockFifo.prepareToRead(blockFifo.getNumReady(), start1, size1, start2, size2);
+
+    const int numBlocks = size1 + size2;
+    std::copy(blocks.begin() + start1, blocks.begin() + start1 + size1, pending.begin());
+    std::copy(blocks.begin() + start2, blocks.begin() + start2 + size2, pending.begin() + size1);
+    blockFifo.finishedRead(numBlocks);
+
+    // Join consecutive blocks of the same kind and width into one call; a gap starts a new one
+    for (int i = 0; i < numBlocks;)
+    {
+        const auto& first = pending[(size_t)i];
+        int numSamples = first.numSamples;
+        int j = i + 1;
+
+        for (; j < numBlocks && pending[(size_t)j].silent == first.silent && pending[(size_t)j].numChannels == first.numChannels
+                   && !pending[(size_t)j].resumed; ++j)
+            numSamples += pending[(size_t)j].numSamples;
+
+        if (first.resumed)
+            client.analysisResumed();
+
+        if (first.silent)
+            analyseSilence(first.numChannels, numSamples);
+        else
+            analyseRun(first.numChannels, numSamples);
+
+        i = j;
+    }
+}
+
+void AnalysisWorker::analyseRun(int numChannels, int numSamples)
+{
+    int start1, size1, start2, size2;
+    sampleFifo.prepareToRead(numSamples, start1, size1, start2, size2);
+
+    for (auto [start, size] : { std::make_pair(start1, size1), std::make_pair(start2, size2) })
+    {
+        if (size == 0)
+            continue;
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            pointers[(size_t)ch] = ring.getReadPointer(ch, start);
+
+        client.analyse(pointers.data(), numChannels, size, false);
+    }
+
+    sampleFifo.finishedRead(size1 + size2);
+}
+
+void AnalysisWorker::analyseSilence(int numChannels, int numSamples)
+{
+    for (int ch = 0; ch < numChannels; ++ch)
+        pointers[(size_t)ch] = zeros.getReadPointer(ch);
+
+    for (int start = 0; start < numSamples; start += silenceChunk)
+        client.analyse(pointers.data(), numChannels, juce::jmin(silenceChunk, numSamples - start), true);
+}
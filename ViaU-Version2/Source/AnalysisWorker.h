@@ -0,0 +1,104 @@
+#pragma once
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <array>
+#include <atomic>
+#include <vector>
+#include "AnalysisThreadPool.h"
+
+// Runs the heavier analysers (loudness, true peak, ...) off the audio thread, so the audio
+// thread's cost does not depend on which of them are switched on.
+//
+// The audio thread copies each block into a lock-free sample ring (an AbstractFifo over
+// planar float channels) and then queues the block's length in a small block ring. A block
+// the caller knows is silent is queued without samples, and while no analyser is on the
+// caller skip()s the block and nothing is queued at all. Once notifyIntervalMs of audio has
+// been queued, the audio thread wakes one of the process-wide AnalysisThreadPool threads,
+// which takes everything queued and passes it to the Client in as few calls as the ring
+// layout allows: consecutive blocks are joined, so the analysers see the same continuous
+// stream, later and in bigger pieces.
+//
+// Nothing on the audio thread waits. If either ring is full the block is left out of the
+// analysis and counted; the analysers then have a gap in their input, which
+// getNumDroppedBlocks() reports.
+class AnalysisWorker : private AnalysisThreadPool::Job
+{
+public:
+    struct Client
+    {
+        virtual ~Client() = default;
+
+        // Worker thread. For silent spans, channels point at zeros.
+        virtual void analyse(const float* const* channels, int numChannels, int numSamples, bool silent) = 0;
+
+        // Worker thread, before the first block queued after skipped ones: the stream has a
+        // gap, so whatever the analysers carried over is stale.
+        virtual void analysisResumed() {}
+    };
+
+    static constexpr int maxChannels = 64;
+    static constexpr int maxBlocks = 1024;              // queued blocks
+    static constexpr int notifyIntervalMs = 10;         // queued audio before a pool thread is woken
+    static constexpr double ringSeconds = 0.5;          // queued audio, at least 8 blocks
+    static constexpr int silenceChunk = 4096;           // largest silent span passed at once
+
+    explicit AnalysisWorker(Client& clientToUse);
+    ~AnalysisWorker() override;
+
+    // While the audio thread is stopped (prepareToPlay, releaseResources). prepare() hands
+    // the worker to the pool and release() takes it back, waiting for a drain in progress;
+    // the analysers may only be touched in between.
+    void prepare(double sampleRate, int maxBlockSize, int numChannels);
+    void release();
+
+    // Audio thread. Double input is narrowed to float as it is copied.
+    void push(const float* const* channels, int numChannels, int numSamples) noexcept;
+    void push(const double* const* channels, int numChannels, int numSamples) noexcept;
+    void pushSilence(int numChannels, int numSamples) noexcept;
+
+    // Audio thread, for a block no analyser wants: nothing is queued and nobody is woken, but
+    // the next block that is queued is marked as following a gap.
+    void skip() noexcept { skipped = true; }
+
+    // Any thread
+    juce::int64 getNumDroppedBlocks() const noexcept { return numDropped.load(std::memory_order_relaxed); }
+
+private:
+    struct Block
+    {
+        int numSamples = 0;
+        int numChannels = 0;
+        bool silent = false;
+        bool resumed = false;                           // first block after skipped ones
+    };
+
+    template <typename SampleType>
+    void pushChannels(const SampleType* const* channels, int numChannels, int numSamples) noexcept;
+    bool pushBlock(Block block) noexcept;
+
+    void drain() override;
+    void analyseRun(int numChannels, int numSamples);
+    void analyseSilence(int numChannels, int numSamples);
+
+    Client& client;
+    juce::SharedResourcePointer<AnalysisThreadPool> pool;
+    int shard = -1;                                     // while prepared
+
+    // Audio thread
+    int notifyIntervalSamples = 1;
+    int samplesSinceNotify = 0;
+    bool skipped = false;
+
+    juce::AbstractFifo sampleFifo{ 1 };
+    juce::AudioBuffer<float> ring;
+    juce::AbstractFifo blockFifo{ maxBlocks };
+    std::array<Block, maxBlocks> blocks {};
+
+    // Worker thread
+    std::vector<Block> pending;
+    juce::AudioBuffer<float> zeros;
+    std::array<const float*, maxChannels> pointers {};
+
+    std::atomic<juce::int64> numDropped{ 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AnalysisWorker)
+};
@@ -0,0 +1,107 @@
+#include "CorrelationMeter.h"
+#include "../../ViaU-Common/MeteringCore.h"
+#include <cmath>
+
+namespace
+{
+    constexpr double silentPower = 1.0e-8;              // -80 dBFS
+}
+
+void CorrelationMeter::prepare(double newSampleRate)
+{
+    sampleRate = newSampleRate;
+    decimation = juce::jmax(1, juce::roundToInt(sampleRate / pointRateHz));
+    alphaPerSubBlock = std::exp(-(double)subBlockSize / (timeConstantSeconds * sampleRate));
+    reset();
+}
+
+void CorrelationMeter::reset() noexcept
+{
+    meanLR = meanLL = meanRR = 0.0;
+    nextPointOffset = 0;
+    correlation.store(0.0f, std::memory_order_relaxed);
+}
+
+void CorrelationMeter::process(const float* const* channels, int numChannels, int numSamples) noexcept
+{
+    if (numChannels <= 0)
+    {
+        processSilence(numSamples);
+        return;
+    }
+
+    const float* left = channels[0];
+    const float* right = numChannels > 1 ? channels[1] : channels[0];
+
+    for (int start = 0; start < numSamples; start += subBlockSize)
+    {
+        const int n = juce::jmin(subBlockSize, numSamples - start);
+        const auto sums = viau::kernels::stereoSums(left + start, right + start, n);
+        integrate(sums.lr, sums.ll, sums.rr, n);
+    }
+
+    pushPoints(left, right, numSamples);
+}
+
+void CorrelationMeter::processSilence(int numSamples) noexcept
+{
+    for (int start = 0; start < numSamples; start += subBlockSize)
+        integrate(0.0, 0.0, 0.0, juce::jmin(subBlockSize, numSamples - start));
+
+    nextPointOffset = 0;
+}
+
+void CorrelationMeter::integrate(double lr, double ll, double rr, int numSamples) noexcept
+{
+    // The sub-block mean goes into the one-pole as a step; at 256 samples against 300 ms the
+    // difference to running it per sample is negligible
+    const double a = numSamples == subBlockSize ? alphaPerSubBlock
+                                                : std::exp(-(double)numSamples / (timeConstantSeconds * sampleRate));
+    const double g = (1.0 - a) / (double)numSamples;
+
+    meanLR = a * meanLR + g * lr;
+    meanLL = a * meanLL + g * ll;
+    meanRR = a * meanRR + g * rr;
+
+    // Flush the integrators to zero once the signal has gone, out of the denormal range
+    if (meanLL + meanRR < silentPower * 1.0e-4)
+        meanLR = meanLL = meanRR = 0.0;
+
+    const double power = 0.5 * (meanLL + meanRR);
+    const double value = power > silentPower ? meanLR / std::sqrt(meanLL * meanRR + 1.0e-30) : 0.0;
+    correlation.store((float)juce::jlimit(-1.0, 1.0, value), std::memory_order_relaxed);
+}
+
+void CorrelationMeter::pushPoints(const float* left, const float* right, int numSamples) noexcept
+{
+    const int numPoints = nextPointOffset < numSamples ? (numSamples - nextPointOffset + decimation - 1) / decimation : 0;
+
+    int start1, size1, start2, size2;
+    pointFifo.prepareToWrite(numPoints, start1, size1, start2, size2);
+
+    int i = nextPointOffset;
+    auto write = [&](int start, int size)
+        {
+            for (int p = start; p < start + size; ++p, i += decimation)
+                points[(size_t)p] = { 0.5f * (right[i] - left[i]), 0.5f * (left[i] + right[i]) };
+        };
+
+    write(start1, size1);
+    write(start2, size2);
+    pointFifo.finishedWrite(size1 + size2);
+
+    // Offset of the next decimated sample in the following block, whether or not this block's
+    // points all fitted
+    nextPointOffset = nextPointOffset + numPoints * decimation - numSamples;
+}
+
+int CorrelationMeter::popPoints(Point* dest, int maxNum) noexcept
+{
+    int start1, size1, start2, size2;
+    pointFifo.prepareToRead(maxNum, start1, size1, start2, size2);
+
+    std::copy(points.begin() + start1, points.begin() + start1 + size1, dest);
+    std::copy(points.begin() + start2, points.begin() + start2 + size2, dest + size1);
+    pointFifo.finishedRead(size1 + size2);
+    return size1 + size2;
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <array>
+#include <atomic>
+
+// Phase correlation and a goniometer point stream for the first two channels.
+//
+// Per sub-block of subBlockSize samples, one SIMD pass (viau::kernels::stereoSums) gives the
+// L*R, L^2 and R^2 sums. These feed three one-pole integrators with a 300 ms time constant,
+// and the correlation is their normalised ratio: +1 for mono, 0 for unrelated channels, -1 for
+// inverted polarity. Below -80 dBFS average power it reads 0. A mono bus reads +1.
+//
+// Every decimation-th sample pair also becomes a goniometer point, queued for the editor in a
+// lock-free single-producer/single-consumer ring. Points the ring has no room for (the editor
+// is closed or showing another view) are dropped.
+class CorrelationMeter
+{
+public:
+    // Vectorscope coordinates: x = (R - L) / 2, y = (L + R) / 2. Full-scale mono reaches y = 1;
+    // a left-only signal lies on the upper-left diagonal.
+    struct Point
+    {
+        float x = 0.0f;
+        float y = 0.0f;
+    };
+
+    static constexpr int pointCapacity = 8192;
+    static constexpr double pointRateHz = 12000.0;
+    static constexpr double timeConstantSeconds = 0.3;
+    static constexpr int subBlockSize = 256;
+
+    CorrelationMeter() = default;
+
+    void prepare(double sampleRate);
+    void reset() noexcept;
+
+    // Processing thread (ViaU's analysis worker)
+    void process(const float* const* channels, int numChannels, int numSamples) noexcept;
+    void processSilence(int numSamples) noexcept;
+
+    // Any thread
+    float getCorrelation() const noexcept { return correlation.load(std::memory_order_relaxed); }
+
+    // Message thread. Copies up to maxNum points into dest, oldest first.
+    int popPoints(Point* dest, int maxNum) noexcept;
+
+private:
+    void integrate(double lr, double ll, double rr, int numSamples) noexcept;
+    void pushPoints(const float* left, const float* right, int numSamples) noexcept;
+
+    double sampleRate = 48000.0;
+    int decimation = 4;
+    int nextPointOffset = 0;
+    double alphaPerSubBlock = 0.0;
+    double meanLR = 0.0, meanLL = 0.0, meanRR = 0.0;
+
+    std::atomic<float> correlation{ 0.0f };
+
+    juce::AbstractFifo pointFifo{ pointCapacity };
+    std::array<Point, pointCapacity> points {};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CorrelationMeter)
+};
@@ -0,0 +1,307 @@
+#include "LoudnessMeter.h"
+#include <cmath>
+
+//==============================================================================
+void LoudnessMeter::Histogram::clear() noexcept
+{
+    counts.fill(0);
+    powers.fill(0.0);
+    totalCount = 0;
+    totalPower = 0.0;
+}
+
+void LoudnessMeter::Histogram::add(double power) noexcept
+{
+    const float lufs = powerToLufs(power);
+    if (!(lufs > minLufs))  // absolute gate
+        return;
+
+    const int bin = binFor(lufs);
+    ++counts[(size_t)bin];
+    powers[(size_t)bin] += power;
+    ++totalCount;
+    totalPower += power;
+}
+
+int LoudnessMeter::Histogram::binFor(float lufs) noexcept
+{
+    return juce::jlimit(0, numBins - 1, (int)std::floor((lufs - minLufs) / binWidth));
+}
+
+//==============================================================================
+void LoudnessMeter::prepare(double sampleRate, const juce::AudioChannelSet& layout)
+{
+    // K-weighting (BS.1770-4): high-shelf pre-filter followed by the RLB high-pass, derived
+    // from the analogue prototypes so any sample rate gets the same response.
+    {
+        const double f0 = 1681.974450955533;
+        const double gainDb = 3.999843853973347;
+        const double q = 0.7071752369554196;
+
+        const double k = std::tan(juce::MathConstants<double>::pi * f0 / sampleRate);
+        const double vh = std::pow(10.0, gainDb / 20.0);
+        const double vb = std::pow(vh, 0.4996667741545416);
+        const double a0 = 1.0 + k / q + k * k;
+
+        shelf.b0 = (vh + vb * k / q + k * k) / a0;
+        shelf.b1 = 2.0 * (k * k - vh) / a0;
+        shelf.b2 = (vh - vb * k / q + k * k) / a0;
+        shelf.a1 = 2.0 * (k * k - 1.0) / a0;
+        shelf.a2 = (1.0 - k / q + k * k) / a0;
+    }
+
+    {
+        const double f0 = 38.13547087602444;
+        const double q = 0.5003270373238773;
+
+        const double k = std::tan(juce::MathConstants<double>::pi * f0 / sampleRate);
+        const double a0 = 1.0 + k / q + k * k;
+
+        highPass.b0 = 1.0;
+        highPass.b1 = -2.0;
+        highPass.b2 = 1.0;
+        highPass.a1 = 2.0 * (k * k - 1.0) / a0;
+        highPass.a2 = (1.0 - k / q + k * k) / a0;
+    }
+
+    // Channel weights: LFE excluded, surrounds +1.5 dB, everything else unity.
+    for (int ch = 0; ch < maxChannels; ++ch)
+    {
+        double weight = 1.0;
+
+        if (ch < layout.size())
+        {
+            switch (layout.getTypeOfChannel(ch))
+            {
+                case juce::AudioChannelSet::LFE:
+                case juce::AudioChannelSet::LFE2:
+                    weight = 0.0;
+                    break;
+
+                case juce::AudioChannelSet::leftSurround:
+                case juce::AudioChannelSet::rightSurround:
+                case juce::AudioChannelSet::leftSurroundSide:
+                case juce::AudioChannelSet::rightSurroundSide:
+                case juce::AudioChannelSet::leftSurroundRear:
+                case juce::AudioChannelSet::rightSurroundRear:
+                    weight = 1.41;
+                    break;
+
+                default:
+                    break;
+            }
+        }
+
+        channelWeights[(size_t)ch] = weight;
+    }
+
+    subBlockLength = juce::jmax(1, juce::roundToInt(sampleRate * 0.1));
+    resetState();
+}
+
+void LoudnessMeter::resetState() noexcept
+{
+    for (auto& state : filterState)
+        state.fill(0.0);
+
+    subBlockFill = 0;
+    subBlockEnergy = 0.0;
+    subBlockPowers.fill(0.0);
+    subBlockIndex = 0;
+    numSubBlocks = 0;
+
+    gatingBlocks.clear();
+    shortTermBlocks.clear();
+
+    momentary.store(noValue);
+    shortTerm.store(noValue);
+    integrated.store(noValue);
+    loudnessRange.store(0.0f);
+}
+
+//==============================================================================
+void LoudnessMeter::process(const float* const* channels, int numChannels, int numSamples) noexcept
+{
+    processChannels(channels, numChannels, numSamples);
+}
+
+void LoudnessMeter::process(const double* const* channels, int numChannels, int numSamples) noexcept
+{
+    processChannels(channels, numChannels, numSamples);
+}
+
+template <typename SampleType>
+void LoudnessMeter::processChannels(const SampleType* const* channels, int numChannels, int numSamples) noexcept
+{
+    if (resetRequested.exchange(false))
+        resetState();
+
+    numChannels = juce::jmin(numChannels, maxChannels);
+
+    for (int pos = 0; pos < numSamples;)
+    {
+        const int n = juce::jmin(numSamples - pos, subBlockLength - subBlockFill);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            const double sumOfSquares = filterChannel(ch, channels[ch] + pos, n);
+            subBlockEnergy += channelWeights[(size_t)ch] * sumOfSquares;
+        }
+
+        pos += n;
+        subBlockFill += n;
+
+        if (subBlockFill == subBlockLength)
+            completeSubBlock();
+    }
+}
+
+bool LoudnessMeter::advanceSilence(int numSamples) noexcept
+{
+    if (resetRequested.exchange(false))
+        resetState();
+
+    // filterChannel() flushes decayed state to exactly zero
+    for (const auto& state : filterState)
+        for (auto s : state)
+            if (s != 0.0)
+                return false;
+
+    for (int pos = 0; pos < numSamples;)
+    {
+        const int n = juce::jmin(numSamples - pos, subBlockLength - subBlockFill);
+        pos += n;
+        subBlockFill += n;
+
+        if (subBlockFill == subBlockLength)
+            completeSubBlock();
+    }
+
+    return true;
+}
+
+template <typename SampleType>
+double LoudnessMeter::filterChannel(int ch, const SampleType* x, int numSamples) noexcept
+{
+    auto& s = filterState[(size_t)ch];
+    double s0 = s[0], s1 = s[1], s2 = s[2], s3 = s[3];
+    double sum = 0.0;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        // Transposed direct form II, two cascaded stages
+        const double in = (double)x[i];
+        const double y = shelf.b0 * in + s0;
+        s0 = shelf.b1 * in - shelf.a1 * y + s1;
+        s1 = shelf.b2 * in - shelf.a2 * y;
+
+        const double z = highPass.b0 * y + s2;
+        s2 = highPass.b1 * y - highPass.a1 * z + s3;
+        s3 = highPass.b2 * y - highPass.a2 * z;
+
+        sum += z * z;
+    }
+
+    // Keep the recursion out of the denormal range during silence
+    auto flush = [](double v) { return std::abs(v) < 1.0e-30 ? 0.0 : v; };
+    s = { flush(s0), flush(s1), flush(s2), flush(s3) };
+    return sum;
+}
+
+void LoudnessMeter::completeSubBlock() noexcept
+{
+    subBlockPowers[(size_t)subBlockIndex] = subBlockEnergy / (double)subBlockLength;
+    subBlockIndex = (subBlockIndex + 1) % shortTermSubBlocks;
+    ++numSubBlocks;
+
+    subBlockFill = 0;
+    subBlockEnergy = 0.0;
+
+    auto meanOfLast = [this](int count)
+        {
+            double sum = 0.0;
+            for (int i = 1; i <= count; ++i)
+                sum += subBlockPowers[(size_t)((subBlockIndex - i + shortTermSubBlocks) % shortTermSubBlocks)];
+            return sum / (double)count;
+        };
+
+    // Before a window has filled, the missing sub-blocks count as silence.
+    const double momentaryPower = meanOfLast(momentarySubBlocks);
+    const double shortTermPower = meanOfLast(shortTermSubBlocks);
+    momentary.store(powerToLufs(momentaryPower));
+    shortTerm.store(powerToLufs(shortTermPower));
+
+    // 400 ms gating blocks with 75 % overlap, 3 s short-term blocks at 10 Hz for LRA
+    if (numSubBlocks >= momentarySubBlocks)
+    {
+        gatingBlocks.add(momentaryPower);
+        updateIntegrated();
+    }
+
+    if (numSubBlocks >= shortTermSubBlocks)
+    {
+        shortTermBlocks.add(shortTermPower);
+        updateLoudnessRange();
+    }
+}
+
+void LoudnessMeter::updateIntegrated() noexcept
+{
+    if (gatingBlocks.totalCount == 0)
+        return;
+
+    // Relative gate: 10 LU below the loudness of all blocks above the absolute gate
+    const float relativeGate = powerToLufs(gatingBlocks.totalPower / (double)gatingBlocks.totalCount) - 10.0f;
+
+    juce::uint64 count = 0;
+    double power = 0.0;
+    for (int bin = Histogram::binFor(relativeGate); bin < Histogram::numBins; ++bin)
+    {
+        count += gatingBlocks.counts[(size_t)bin];
+        power += gatingBlocks.powers[(size_t)bin];
+    }
+
+    if (count > 0)
+        integrated.store(powerToLufs(power / (double)count));
+}
+
+void LoudnessMeter::updateLoudnessRange() noexcept
+{
+    if (shortTermBlocks.totalCount == 0)
+        return;
+
+    // EBU Tech 3342: relative gate 20 LU below the absolute-gated mean, then the spread
+    // between the 10th and 95th percentiles of what remains.
+    const float relativeGate = powerToLufs(shortTermBlocks.totalPower / (double)shortTermBlocks.totalCount) - 20.0f;
+    const int firstBin = Histogram::binFor(relativeGate);
+
+    juce::uint64 count = 0;
+    for (int bin = firstBin; bin < Histogram::numBins; ++bin)
+        count += shortTermBlocks.counts[(size_t)bin];
+
+    if (count == 0)
+        return;
+
+    const double lowTarget = 0.10 * (double)count;
+    const double highTarget = 0.95 * (double)count;
+    int lowBin = -1, highBin = -1;
+    juce::uint64 cumulative = 0;
+
+    for (int bin = firstBin; bin < Histogram::numBins && highBin < 0; ++bin)
+    {
+        cumulative += shortTermBlocks.counts[(size_t)bin];
+
+        if (lowBin < 0 && (double)cumulative > lowTarget)
+            lowBin = bin;
+        if ((double)cumulative >= highTarget)
+            highBin = bin;
+    }
+
+    if (lowBin >= 0 && highBin >= 0)
+        loudnessRange.store((float)(highBin - lowBin) * Histogram::binWidth);
+}
+
+float LoudnessMeter::powerToLufs(double power) noexcept
+{
+    return power > 0.0 ? (float)(-0.691 + 10.0 * std::log10(power)) : noValue;
+}
@@ -0,0 +1,106 @@
+#pragma once
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <array>
+#include <atomic>
+#include <limits>
+
+// EBU R128 / ITU-R BS.1770 loudness: momentary (400 ms), short-term (3 s), integrated and
+// loudness range (LRA).
+//
+// The K-weighted signal is accumulated into 100 ms sub-block energies. Gating blocks are
+// built from those sub-blocks, and instead of storing every block the integrated and LRA
+// gates work on fixed histograms (0.1 LU bins, -70..+5 LUFS) holding a count and the summed
+// power per bin. Memory is therefore constant for any session length, and the per-block
+// work does not grow with it either.
+//
+// Results are published through atomics; requestReset() may be called from any thread.
+class LoudnessMeter
+{
+public:
+    static constexpr int maxChannels = 64;
+    static constexpr float noValue = -std::numeric_limits<float>::infinity();
+
+    LoudnessMeter() = default;
+
+    void prepare(double sampleRate, const juce::AudioChannelSet& layout);
+
+    // Processing thread (ViaU's analysis worker)
+    void process(const float* const* channels, int numChannels, int numSamples) noexcept;
+    void process(const double* const* channels, int numChannels, int numSamples) noexcept;
+
+    // For a block the caller knows is silent: once the K-weighting filters have rung out, only
+    // the sub-block clock needs to advance. Returns false, having done nothing, while the
+    // filters still ring; process() the block then.
+    bool advanceSilence(int numSamples) noexcept;
+
+    // Any thread
+    void requestReset() noexcept { resetRequested.store(true); }
+    float getMomentary() const noexcept { return momentary.load(); }
+    float getShortTerm() const noexcept { return shortTerm.load(); }
+    float getIntegrated() const noexcept { return integrated.load(); }
+    float getLoudnessRange() const noexcept { return loudnessRange.load(); }
+
+private:
+    struct Biquad
+    {
+        double b0 = 1.0, b1 = 0.0, b2 = 0.0, a1 = 0.0, a2 = 0.0;
+    };
+
+    // Loudness histogram for the gated measures
+    struct Histogram
+    {
+        static constexpr float minLufs = -70.0f;
+        static constexpr float maxLufs = 5.0f;
+        static constexpr float binWidth = 0.1f;
+        static constexpr int numBins = 750;
+
+        std::array<juce::uint32, numBins> counts {};
+        std::array<double, numBins> powers {};
+        juce::uint64 totalCount = 0;
+        double totalPower = 0.0;
+
+        void clear() noexcept;
+        void add(double power) noexcept;                  // ignores blocks below the absolute gate
+        static int binFor(float lufs) noexcept;
+    };
+
+    void resetState() noexcept;
+
+    template <typename SampleType>
+    void processChannels(const SampleType* const* channels, int numChannels, int numSamples) noexcept;
+
+    // The filters run in double either way, so double input is read without narrowing
+    template <typename SampleType>
+    double filterChannel(int ch, const SampleType* x, int numSamples) noexcept;
+    void completeSubBlock() noexcept;
+    void updateIntegrated() noexcept;
+    void updateLoudnessRange() noexcept;
+
+    static float powerToLufs(double power) noexcept;
+
+    static constexpr int momentarySubBlocks = 4;        // 400 ms
+    static constexpr int shortTermSubBlocks = 30;       // 3 s
+
+    Biquad shelf, highPass;                             // K-weighting stages
+    std::array<std::array<double, 4>, maxChannels> filterState {};
+    std::array<double, maxChannels> channelWeights {};
+
+    int subBlockLength = 4800;
+    int subBlockFill = 0;
+    double subBlockEnergy = 0.0;
+
+    std::array<double, shortTermSubBlocks> subBlockPowers {};
+    int subBlockIndex = 0;
+    juce::int64 numSubBlocks = 0;
+
+    Histogram gatingBlocks;                             // 400 ms blocks, for integrated loudness
+    Histogram shortTermBlocks;                          // 3 s blocks, for LRA
+
+    std::atomic<bool> resetRequested{ false };
+    std::atomic<float> momentary{ noValue };
+    std::atomic<float> shortTerm{ noValue };
+    std::atomic<float> integrated{ noValue };
+    std::atomic<float> loudnessRange{ 0.0f };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LoudnessMeter)
+};
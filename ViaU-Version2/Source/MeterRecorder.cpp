@@ -0,0 +1,130 @@
+#include "MeterRecorder.h"
+
+MeterRecorder::MeterRecorder()
+    : juce::Thread("ViaU meter recorder"),
+      queue((size_t)queueCapacity),
+      batch((size_t)queueCapacity)
+{
+}
+
+MeterRecorder::~MeterRecorder()
+{
+    stop();
+}
+
+juce::File MeterRecorder::getDefaultFolder()
+{
+    return juce::File::getSpecialLocation(juce::File::userDocumentsDirectory).getChildFile("ViaU Recordings");
+}
+
+bool MeterRecorder::start(const juce::File& newFile, double sampleRate)
+{
+    stop();
+
+    if (!newFile.getParentDirectory().createDirectory())
+        return false;
+
+    auto newStream = std::make_unique<juce::FileOutputStream>(newFile);
+    if (newStream->failedToOpen())
+        return false;
+
+    header = {};
+    header.indexEntrySize = (juce::uint32)sizeof(MeterIndexEntry);
+    header.sampleRate = sampleRate;
+
+    // The stream buffers, so a full disk only shows once the header is flushed
+    newStream->setPosition(0);
+    bool headerWritten = newStream->truncate().wasOk() && newStream->write(&header, sizeof(header));
+    if (headerWritten)
+    {
+        newStream->flush();
+        headerWritten = newStream->getStatus().wasOk();
+    }
+
+    if (!headerWritten)
+    {
+        newStream.reset();
+        newFile.deleteFile();
+        return false;
+    }
+
+    file = newFile;
+    stream = std::move(newStream);
+    indexBuilder = {};
+    writeFailed = false;
+    numDropped.store(0, std::memory_order_relaxed);
+
+    // Anything left from an earlier recording belongs to it, not to this one. The audio
+    // thread can't be pushing: recording is still false.
+    fifo.reset();
+
+    recording.store(true, std::memory_order_release);
+    startThread();
+    return true;
+}
+
+void MeterRecorder::stop()
+{
+    if (!isRecording())
+        return;
+
+    recording.store(false, std::memory_order_release);
+    signalThreadShouldExit();
+    notify();
+    stopThread(5000);
+
+    finish();
+}
+
+void MeterRecorder::run()
+{
+    while (!threadShouldExit())
+    {
+        wait(writeIntervalMs);
+        drain();
+    }
+
+    drain();
+}
+
+void MeterRecorder::drain()
+{
+    const auto scope = fifo.read(fifo.getNumReady());
+    const auto numRead = scope.blockSize1 + scope.blockSize2;
+
+    if (numRead == 0)
+        return;
+
+    std::copy_n(queue.begin() + scope.startIndex1, scope.blockSize1, batch.begin());
+    std::copy_n(queue.begin() + scope.startIndex2, scope.blockSize2, batch.begin() + scope.blockSize1);
+
+    // The records are already released to the audio thread; batch holds the copy
+    for (int i = 0; i < numRead; ++i)
+        indexBuilder.add(batch[(size_t)i], header.numRecords + i, header.recordsPerIndexEntry);
+
+    header.numRecords += numRead;
+
+    if (!writeFailed && !stream->write(batch.data(), (size_t)numRead * sizeof(MeterRecord)))
+        writeFailed = true;
+}
+
+void MeterRecorder::finish()
+{
+    if (stream == nullptr)
+        return;
+
+    // A failed write leaves the header unpatched; the reader recovers whatever made it to disk
+    if (!writeFailed)
+    {
+        stream->flush();
+        header.indexOffset = stream->getPosition();
+        header.numIndexEntries = (juce::int64)indexBuilder.entries.size();
+        header.numDropped = numDropped.load(std::memory_order_relaxed);
+
+        if (stream->write(indexBuilder.entries.data(), indexBuilder.entries.size() * sizeof(MeterIndexEntry))
+            && stream->setPosition(0))
+            stream->write(&header, sizeof(header));
+    }
+
+    stream.reset();
+}
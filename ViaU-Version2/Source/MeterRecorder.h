@@ -0,0 +1,66 @@
+#pragma once
+#include <juce_core/juce_core.h>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "MeterRecording.h"
+
+// Spools per-block meter readings to a .viaurec file (format in MeterRecording.h).
+//
+// The audio thread only push()es into a preallocated single-producer/single-consumer queue;
+// a full queue drops the record and counts it rather than waiting. A background thread wakes
+// every writeIntervalMs, drains whatever has arrived into one batch, appends it with a single
+// write, and extends the time index. The index, the final counts and the drop count are
+// written when recording stops.
+//
+// start() and stop() run on the message thread. A start() that fails leaves no file behind.
+class MeterRecorder : private juce::Thread
+{
+public:
+    static constexpr int queueCapacity = 16384;         // ~3 minutes of 512-sample blocks at 48 kHz
+    static constexpr int writeIntervalMs = 50;
+
+    MeterRecorder();
+    ~MeterRecorder() override;
+
+    bool start(const juce::File& file, double sampleRate);
+    void stop();
+    bool isRecording() const noexcept { return recording.load(std::memory_order_acquire); }
+    const juce::File& getFile() const noexcept { return file; }
+
+    // Where recordings go unless the caller picks a file
+    static juce::File getDefaultFolder();
+
+    // Audio thread
+    void push(const MeterRecord& record) noexcept
+    {
+        if (!recording.load(std::memory_order_acquire))
+            return;
+
+        const auto scope = fifo.write(1);
+        if (scope.blockSize1 > 0)
+            queue[(size_t)scope.startIndex1] = record;
+        else
+            numDropped.fetch_add(1, std::memory_order_relaxed);
+    }
+
+private:
+    void run() override;
+    void drain();
+    void finish();
+
+    juce::AbstractFifo fifo{ queueCapacity };
+    std::vector<MeterRecord> queue;
+    std::vector<MeterRecord> batch;
+    std::atomic<bool> recording{ false };
+    std::atomic<juce::int64> numDropped{ 0 };
+
+    // Writer thread while recording, message thread otherwise
+    juce::File file;
+    std::unique_ptr<juce::FileOutputStream> stream;
+    MeterRecordingHeader header;
+    MeterIndexBuilder indexBuilder;
+    bool writeFailed = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MeterRecorder)
+};
@@ -0,0 +1,128 @@
+#include "MeterRecording.h"
+#include <algorithm>
+#include <cstring>
+
+void MeterIndexBuilder::add(const MeterRecord& record, juce::int64 recordNumber, juce::uint32 recordsPerEntry)
+{
+    if (recordNumber % (juce::int64)recordsPerEntry == 0)
+    {
+        MeterIndexEntry entry;
+        entry.firstRecord = recordNumber;
+        entries.push_back(entry);
+        lastHostSample = -1;
+    }
+
+    auto& entry = entries.back();
+
+    // Records without host time may only lead a sorted run, where the binary search in
+    // findRecord() takes them as earlier than any host time
+    if (record.hostSample < 0)
+    {
+        if (lastHostSample >= 0)
+            entry.sorted = 0;
+        return;
+    }
+
+    const auto end = record.hostSample + (juce::int64)record.numSamples;
+
+    if (entry.minHostSample < 0)
+    {
+        entry.minHostSample = record.hostSample;
+        entry.maxHostSample = end;
+    }
+    else
+    {
+        entry.minHostSample = juce::jmin(entry.minHostSample, record.hostSample);
+        entry.maxHostSample = juce::jmax(entry.maxHostSample, end);
+    }
+
+    if (record.hostSample < lastHostSample)
+        entry.sorted = 0;
+
+    lastHostSample = record.hostSample;
+}
+
+//==============================================================================
+MeterRecordingReader::MeterRecordingReader(const juce::File& file)
+    : mappedFile(std::make_unique<juce::MemoryMappedFile>(file, juce::MemoryMappedFile::readOnly))
+{
+    const auto* data = static_cast<const char*>(mappedFile->getData());
+    const auto size = (juce::int64)mappedFile->getSize();
+
+    if (data == nullptr || size < (juce::int64)sizeof(MeterRecordingHeader))
+        return;
+
+    std::memcpy(&header, data, sizeof(header));
+
+    if (std::memcmp(header.magic, MeterRecordingHeader::expectedMagic, sizeof(header.magic)) != 0
+        || header.version != MeterRecordingHeader::currentVersion
+        || header.recordSize != sizeof(MeterRecord)
+        || header.recordsPerIndexEntry == 0)
+        return;
+
+    // An unfinished file has no counts and no index: everything after the header is records
+    const bool finished = header.numRecords > 0 && header.indexOffset > 0
+                       && header.indexEntrySize == sizeof(MeterIndexEntry)
+                       && header.indexOffset + header.numIndexEntries * (juce::int64)sizeof(MeterIndexEntry) <= size;
+
+    const auto recordBytes = (finished ? header.indexOffset : size) - (juce::int64)sizeof(MeterRecordingHeader);
+    numRecords = finished ? header.numRecords : recordBytes / (juce::int64)sizeof(MeterRecord);
+    records = reinterpret_cast<const MeterRecord*>(data + sizeof(MeterRecordingHeader));
+
+    if (finished)
+    {
+        const auto* entries = reinterpret_cast<const MeterIndexEntry*>(data + header.indexOffset);
+        index.assign(entries, entries + header.numIndexEntries);
+    }
+    else
+    {
+        buildIndex();
+    }
+}
+
+void MeterRecordingReader::buildIndex()
+{
+    MeterIndexBuilder builder;
+    for (juce::int64 i = 0; i < numRecords; ++i)
+        builder.add(records[i], i, header.recordsPerIndexEntry);
+
+    index = std::move(builder.entries);
+}
+
+juce::int64 MeterRecordingReader::findRecord(juce::int64 hostSample) const noexcept
+{
+    auto contains = [hostSample](const MeterRecord& r)
+        {
+            return r.hostSample >= 0 && hostSample >= r.hostSample && hostSample < r.hostSample + (juce::int64)r.numSamples;
+        };
+
+    for (size_t e = 0; e < index.size(); ++e)
+    {
+        const auto& entry = index[e];
+        if (entry.minHostSample < 0 || hostSample < entry.minHostSample || hostSample >= entry.maxHostSample)
+            continue;
+
+        const auto first = entry.firstRecord;
+        const auto last = e + 1 < index.size() ? index[e + 1].firstRecord : numRecords;
+
+        if (entry.sorted != 0)
+        {
+            // Last record starting at or before hostSample; records without host time sort first
+            const auto* begin = records + first;
+            const auto* end = records + last;
+            const auto* it = std::upper_bound(begin, end, hostSample,
+                [](juce::int64 t, const MeterRecord& r) { return t < r.hostSample; });
+
+            if (it != begin && contains(*(it - 1)))
+                return (it - 1) - records;
+        }
+        else
+        {
+            for (auto i = first; i < last; ++i)
+                if (contains(records[i]))
+                    return i;
+        }
+    }
+
+    return -1;
+}
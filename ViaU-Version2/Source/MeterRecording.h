@@ -0,0 +1,97 @@
+#pragma once
+#include <juce_core/juce_core.h>
+#include <memory>
+#include <vector>
+
+// On-disk format of meter recordings (.viaurec), and a memory-mapped reader for them.
+//
+//   MeterRecordingHeader                     64 bytes
+//   MeterRecord[numRecords]                  32 bytes each, one per processed block
+//   MeterIndexEntry[numIndexEntries]         one per recordsPerIndexEntry records
+//
+// Native byte order. The records are fixed size and contiguous, so a mapped file can be
+// used as an array directly. The index and the final counts are written when recording
+// stops. If that never happened (crash, host killed), the reader derives the record count
+// from the file size and rebuilds the index in memory.
+struct MeterRecord
+{
+    static constexpr juce::uint32 playing = 1;          // flags
+    static constexpr juce::uint32 peakHit = 2;
+
+    juce::int64 hostSample = -1;                        // AudioPlayHead time in samples, -1 if unknown
+    juce::int64 processedSample = 0;                    // first sample of the block since prepareToPlay
+    float vu = -20.0f;                                  // VU units after the block
+    float peak = 0.0f;                                  // max |x| over the block and all channels
+    juce::uint32 numSamples = 0;
+    juce::uint32 flags = 0;
+};
+
+struct MeterRecordingHeader
+{
+    static constexpr char expectedMagic[8] = { 'V', 'I', 'A', 'U', 'R', 'E', 'C', 0 };
+    static constexpr juce::uint32 currentVersion = 1;
+
+    char magic[8] = { 'V', 'I', 'A', 'U', 'R', 'E', 'C', 0 };
+    juce::uint32 version = currentVersion;
+    juce::uint32 recordSize = (juce::uint32)sizeof(MeterRecord);
+    juce::uint32 recordsPerIndexEntry = 4096;
+    juce::uint32 indexEntrySize = 0;                    // sizeof(MeterIndexEntry), set by the writer
+    double sampleRate = 0.0;
+    juce::int64 numRecords = 0;                         // 0 until the recording is finished
+    juce::int64 indexOffset = 0;                        // byte offset of the index, 0 if absent
+    juce::int64 numIndexEntries = 0;
+    juce::int64 numDropped = 0;                         // records lost to a full queue
+};
+
+// Host time range covered by a run of records, for seeking
+struct MeterIndexEntry
+{
+    juce::int64 firstRecord = 0;
+    juce::int64 minHostSample = -1;                     // -1 if no record in the run had a host time
+    juce::int64 maxHostSample = -1;                     // end of the last block, exclusive
+    juce::int64 sorted = 1;                             // host times never went backwards in the run
+};
+
+static_assert(sizeof(MeterRecord) == 32, "MeterRecord is part of the file format");
+static_assert(sizeof(MeterRecordingHeader) == 64, "MeterRecordingHeader is part of the file format");
+static_assert(sizeof(MeterIndexEntry) == 32, "MeterIndexEntry is part of the file format");
+
+//==============================================================================
+class MeterRecordingReader
+{
+public:
+    explicit MeterRecordingReader(const juce::File& file);
+
+    bool isValid() const noexcept { return records != nullptr; }
+    const MeterRecordingHeader& getHeader() const noexcept { return header; }
+    double getSampleRate() const noexcept { return header.sampleRate; }
+    juce::int64 getNumRecords() const noexcept { return numRecords; }
+    const MeterRecord& getRecord(juce::int64 index) const noexcept { return records[index]; }
+
+    // Index of the record whose block contains hostSample, or -1. Uses the time index to go
+    // straight to the right run of records, then a binary search when host time only moved
+    // forward within it (a linear scan otherwise, e.g. across a loop jump).
+    juce::int64 findRecord(juce::int64 hostSample) const noexcept;
+
+private:
+    void buildIndex();
+
+    std::unique_ptr<juce::MemoryMappedFile> mappedFile;
+    MeterRecordingHeader header;
+    const MeterRecord* records = nullptr;
+    juce::int64 numRecords = 0;
+    std::vector<MeterIndexEntry> index;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MeterRecordingReader)
+};
+
+//==============================================================================
+// Builds index entries as records are appended; shared by the writer and the reader's
+// fallback.
+struct MeterIndexBuilder
+{
+    void add(const MeterRecord& record, juce::int64 recordNumber, juce::uint32 recordsPerEntry);
+
+    std::vector<MeterIndexEntry> entries;
+    juce::int64 lastHostSample = -1;
+};
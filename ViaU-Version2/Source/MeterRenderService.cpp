@@ -0,0 +1,123 @@
+#include "MeterRenderService.h"
+
+namespace
+{
+    constexpr int housekeepingHz = 5;
+    constexpr double vBlankTimeoutMs = 250.0;   // after this, the timer ticks in place of vblank
+}
+
+MeterRenderService::MeterRenderService()
+{
+    startTimerHz(housekeepingHz);
+}
+
+MeterRenderService::~MeterRenderService()
+{
+    jassert(clients.isEmpty() && housekeepers.isEmpty());
+    vBlankAttachment.reset();
+}
+
+void MeterRenderService::addClient(Client* client)
+{
+    clients.addIfNotAlreadyThere(client);
+    electVBlankSource();
+}
+
+void MeterRenderService::removeClient(Client* client)
+{
+    clients.removeFirstMatchingValue(client);
+
+    if (client == vBlankSource)
+    {
+        vBlankAttachment.reset();
+        vBlankSource = nullptr;
+    }
+
+    electVBlankSource();
+}
+
+void MeterRenderService::addHousekeeper(Housekeeper* housekeeper)
+{
+    housekeepers.addIfNotAlreadyThere(housekeeper);
+}
+
+void MeterRenderService::removeHousekeeper(Housekeeper* housekeeper)
+{
+    housekeepers.removeFirstMatchingValue(housekeeper);
+}
+
+bool MeterRenderService::isShowing(Client& client)
+{
+    auto& component = client.getRenderComponent();
+    if (!component.isShowing())
+        return false;
+
+    auto* peer = component.getPeer();
+    return peer != nullptr && !peer->isMinimised();
+}
+
+void MeterRenderService::electVBlankSource()
+{
+    if (vBlankSource != nullptr && isShowing(*vBlankSource))
+        return;
+
+    vBlankAttachment.reset();
+    vBlankSource = nullptr;
+
+    for (auto* client : clients)
+    {
+        if (isShowing(*client))
+        {
+            vBlankSource = client;
+            vBlankAttachment = std::make_unique<juce::VBlankAttachment>(&client->getRenderComponent(), [this] { tick(); });
+            break;
+        }
+    }
+}
+
+void MeterRenderService::timerCallback()
+{
+    electVBlankSource();
+
+    // No vblank arriving (nothing showing, or the source just went away): keep clients ticking
+    if (juce::Time::getMillisecondCounterHiRes() - lastTickMs > vBlankTimeoutMs)
+        tick();
+
+    for (auto* housekeeper : housekeepers)
+        housekeeper->housekeep();
+}
+
+void MeterRenderService::tick()
+{
+    const double startMs = juce::Time::getMillisecondCounterHiRes();
+    const bool hiddenFrame = (frameCounter % hiddenFrameDivider) == 0;
+    const bool idleFrame = (frameCounter % idleFrameDivider) == 0;
+    int numShowing = 0, numIdle = 0;
+
+    // Everything in one pass, so the repaints of all editors coalesce into the same frame
+    for (auto* client : clients)
+    {
+        const bool showing = isShowing(*client);
+        const bool idle = client->isIdle();
+        numShowing += showing ? 1 : 0;
+        numIdle += idle ? 1 : 0;
+
+        if ((showing && (!idle || idleFrame)) || hiddenFrame || vBlankSource == nullptr)
+            client->renderFrame();
+    }
+
+    const double endMs = juce::Time::getMillisecondCounterHiRes();
+    const double frameMs = endMs - startMs;
+
+    if (lastTickMs > 0.0 && startMs > lastTickMs)
+        stats.framesPerSecond += 0.05 * (1000.0 / (startMs - lastTickMs) - stats.framesPerSecond);
+
+    stats.meanFrameMs += 0.05 * (frameMs - stats.meanFrameMs);
+    stats.maxFrameMs = juce::jmax(stats.maxFrameMs, frameMs);
+    stats.numClients = clients.size();
+    stats.numShowing = numShowing;
+    stats.numIdle = numIdle;
+    stats.numFrames = ++frameCounter;
+
+    lastTickMs = startMs;
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include <juce_gui_extra/juce_gui_extra.h>
+
+// Process-wide frame scheduler for every open ViaU editor.
+//
+// Held through juce::SharedResourcePointer, so all plugin instances in a process share one.
+// A single VBlankAttachment (on the first showing editor) ticks every client in one pass.
+// Showing editors render every frame, unless they report themselves idle (nothing to show
+// until their input returns), in which case every idleFrameDivider frames. Hidden or
+// minimised ones render only every hiddenFrameDivider frames, which is enough to keep their
+// snapshot queues drained. Idleness is asked for on every frame, so a client wakes up on the
+// next vblank after its signal returns. A slow
+// housekeeping timer re-elects the vblank source and keeps hidden editors ticking when no
+// editor is showing. The same timer runs every processor's own housekeeping (Housekeeper),
+// so a session of plugins has one message-thread timer between them, not one per instance.
+//
+// Message thread only.
+class MeterRenderService : private juce::Timer
+{
+public:
+    struct Client
+    {
+        virtual ~Client() = default;
+        virtual juce::Component& getRenderComponent() = 0;
+        virtual void renderFrame() = 0;
+        virtual bool isIdle() { return false; }
+    };
+
+    struct Housekeeper
+    {
+        virtual ~Housekeeper() = default;
+        virtual void housekeep() = 0;           // every housekeeping tick, editor or not
+    };
+
+    struct Stats
+    {
+        int numClients = 0;
+        int numShowing = 0;
+        int numIdle = 0;
+        juce::int64 numFrames = 0;
+        double meanFrameMs = 0.0;       // exponentially averaged cost of one tick over all clients
+        double maxFrameMs = 0.0;
+        double framesPerSecond = 0.0;
+    };
+
+    MeterRenderService();
+    ~MeterRenderService() override;
+
+    void addClient(Client* client);
+    void removeClient(Client* client);
+
+    void addHousekeeper(Housekeeper* housekeeper);
+    void removeHousekeeper(Housekeeper* housekeeper);
+
+    Stats getStats() const noexcept { return stats; }
+
+    static constexpr int hiddenFrameDivider = 15;   // ~4 Hz on a 60 Hz display
+    static constexpr int idleFrameDivider = 30;     // ~2 Hz, keeps slow readouts (LUFS) moving
+
+private:
+    void timerCallback() override;
+    void tick();
+    void electVBlankSource();
+    static bool isShowing(Client& client);
+
+    juce::Array<Client*> clients;
+    juce::Array<Housekeeper*> housekeepers;
+    Client* vBlankSource = nullptr;
+    std::unique_ptr<juce::VBlankAttachment> vBlankAttachment;
+
+    juce::int64 frameCounter = 0;
+    double lastTickMs = 0.0;
+    Stats stats;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MeterRenderService)
+};
@@ -0,0 +1,80 @@
+#pragma once
+#include <juce_core/juce_core.h>
+#include <array>
+#include <atomic>
+
+// One processed block as seen by the meter.
+struct MeterSnapshot
+{
+    static constexpr int maxChannels = 64;
+
+    juce::int64 samplePosition = 0;     // first sample of the block, counted since prepareToPlay
+    float vu = -20.0f;                  // VU units after the block
+    float peak = 0.0f;                  // max |x| across all channels (linear)
+    bool peakHit = false;
+    int numChannels = 0;
+    std::array<float, maxChannels> channelPeak {}; // max |x| per channel (linear)
+    std::array<float, maxChannels> channelVU {};   // per-channel ballistics, VU units
+    bool hasReference = false;          // the reference (sidechain) bus is connected
+    float referenceVU = -20.0f;         // reference bus, same ballistics, VU units
+    float referenceDelta = 0.0f;        // main minus reference level in dB, unclamped
+
+    // Folds a later block into this one, keeping the maxima and the latest VU.
+    void merge(const MeterSnapshot& later) noexcept
+    {
+        vu = later.vu;
+        peak = juce::jmax(peak, later.peak);
+        peakHit = peakHit || later.peakHit;
+        numChannels = juce::jmax(numChannels, later.numChannels);
+        for (int ch = 0; ch < maxChannels; ++ch)
+            channelPeak[(size_t)ch] = juce::jmax(channelPeak[(size_t)ch], later.channelPeak[(size_t)ch]);
+        channelVU = later.channelVU;
+        hasReference = later.hasReference;
+        referenceVU = later.referenceVU;
+        referenceDelta = later.referenceDelta;
+    }
+};
+
+// Wait-free single-producer/single-consumer ring of MeterSnapshots.
+// push() is called from the audio thread, pop() from the message thread. Neither locks or allocates.
+template <int Capacity>
+class MeterSnapshotQueue
+{
+public:
+    MeterSnapshotQueue() = default;
+
+    // Returns false (and leaves the queue untouched) when the consumer has fallen behind.
+    bool push(const MeterSnapshot& snapshot) noexcept
+    {
+        int start1, size1, start2, size2;
+        fifo.prepareToWrite(1, start1, size1, start2, size2);
+
+        if (size1 + size2 == 0)
+            return false;
+
+        slots[(size_t)(size1 > 0 ? start1 : start2)] = snapshot;
+        fifo.finishedWrite(1);
+        return true;
+    }
+
+    // Copies up to maxNum snapshots into dest, oldest first. Returns the number copied.
+    int pop(MeterSnapshot* dest, int maxNum) noexcept
+    {
+        int start1, size1, start2, size2;
+        fifo.prepareToRead(maxNum, start1, size1, start2, size2);
+
+        for (int i = 0; i < size1; ++i)
+            dest[i] = slots[(size_t)(start1 + i)];
+        for (int i = 0; i < size2; ++i)
+            dest[size1 + i] = slots[(size_t)(start2 + i)];
+
+        fifo.finishedRead(size1 + size2);
+        return size1 + size2;
+    }
+
+private:
+    juce::AbstractFifo fifo{ Capacity };
+    std::array<MeterSnapshot, Capacity> slots;
+
+    JUCE_DECLARE_NON_COPYABLE(MeterSnapshotQueue)
+};
@@ -1,30 +1,755 @@
 #include "PluginEditor.h"
 #include <cmath>
 
+namespace
+{
+    constexpr double peakHoldMs = 1500.0;
+    constexpr float peakReleasePerSecond = 15.0f;   // VU per second once the hold expires
+    constexpr double peakHitMs = 500.0;             // keep the peak colour visible this long
+    constexpr float minVisibleChange = 0.5f;        // pixels
+    constexpr double historySeconds = 10.0;
+    constexpr float spectrumMinDb = -72.0f;
+    constexpr float goniometerHalfLifeSeconds = 0.06f;
+    constexpr double goniometerClearMs = 600.0;         // about 10 half-lives: nothing visible left
+
+    float dbToNorm(float db) { return juce::jlimit(0.0f, 1.0f, (db - spectrumMinDb) / -spectrumMinDb); }
+
+    // Tick marks for the current scale: the usual marks that fit inside it and, unless the
+    // caller draws them itself, its ends
+    juce::Array<float> getScaleTicks(const VUScale& scale, bool withEnds = true)
+    {
+        juce::Array<float> ticks;
+        if (withEnds)
+            ticks.add(scale.minVU);
+
+        for (float tickVU : { -30.0f, -20.0f, -10.0f, -5.0f, -3.0f, 0.0f, 3.0f })
+            if (tickVU > scale.minVU + 1.0f && tickVU < scale.maxVU - 1.0f)
+                ticks.add(tickVU);
+
+        if (withEnds)
+            ticks.add(scale.maxVU);
+
+        return ticks;
+    }
+
+    juce::Rectangle<float> getLedOutline(juce::Rectangle<float> bounds)
+    {
+        auto meterBounds = bounds.reduced(6.0f);
+        return meterBounds.withHeight(meterBounds.getHeight() - 6.0f);
+    }
+
+    juce::Rectangle<float> getNeedleDial(juce::Rectangle<float> bounds)
+    {
+        auto r = bounds.reduced(8.0f);
+        float size = juce::jmin(r.getWidth(), r.getHeight());
+        return juce::Rectangle<float>(0, 0, size, size).withCentre(r.getCentre());
+    }
+
+    juce::Point<float> pointOnDial(juce::Point<float> c, float radius, float angle)
+    {
+        return { c.x + radius * std::cos(angle), c.y + radius * std::sin(angle) };
+    }
+}
+
 ViaUAudioProcessorEditor::ViaUAudioProcessorEditor(ViaUAudioProcessor& p)
-    : AudioProcessorEditor(&p), processor(p)
+    : AudioProcessorEditor(&p), processor(p), drainBuffer(256)
 {
+    goniometer.points.resize(1024);
+
+    scale = processor.getScale();
+    vuValue = peakHoldVU = drawnVU = drawnPeakHoldVU = referenceVU = drawnReferenceVU = scale.minVU;
+
     setSize(360, 180);
     displayModeBox.addItem("LED", 1);
     displayModeBox.addItem("Needle", 2);
+    displayModeBox.addItem("History", 3);
+    displayModeBox.addItem("Spectrum", 4);
+    displayModeBox.addItem("Goniometer", 5);
     addAndMakeVisible(displayModeBox);
     displayModeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
         processor.apvts, "displayMode", displayModeBox);
-    startTimerHz(30);
+    displayModeBox.onChange = [this] { repaint(); };
+
+    addAndMakeVisible(truePeakButton);
+    truePeakAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
+        processor.apvts, "truePeak", truePeakButton);
+
+    addAndMakeVisible(loudnessButton);
+    loudnessAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
+        processor.apvts, "loudness", loudnessButton);
+
+    renderService->addClient(this);
+}
+
+ViaUAudioProcessorEditor::~ViaUAudioProcessorEditor()
+{
+    renderService->removeClient(this);
 }
 
 void ViaUAudioProcessorEditor::resized()
 {
     auto r = getLocalBounds().reduced(12);
-    displayModeBox.setBounds(r.removeFromTop(24).removeFromLeft(150));
+    auto topRow = r.removeFromTop(24);
+    displayModeBox.setBounds(topRow.removeFromLeft(150));
+    topRow.removeFromLeft(8);
+    truePeakButton.setBounds(topRow.removeFromLeft(90));
+    topRow.removeFromLeft(8);
+    loudnessButton.setBounds(topRow.removeFromLeft(70));
+
+    auto area = getLocalBounds().toFloat().reduced(12.0f);
+    meterBounds = area.removeFromTop(area.getHeight() - 40.0f);
+    readoutBounds = area.toNearestInt();
+
+   #if VIAU_ENABLE_PROFILING
+    profilerBounds = getLocalBounds().reduced(12).withTrimmedTop(30).removeFromTop(50).removeFromRight(300);
+   #endif
+
+    // Static layers are rebuilt lazily at the new size on the next paint
+    ledBackground = {};
+    ledOverlay = {};
+    needleBackground = {};
+    channelBackground = {};
+    historyBackground = {};
+    historyOverlay = {};
+    spectrumBackground = {};
+    goniometerBackground = {};
+    correlationBackground = {};
+}
+
+bool ViaUAudioProcessorEditor::isIdle()
+{
+    // Silent input, and everything on screen has come to rest at the bottom of the scale. The
+    // history only stops moving visibly once the last signal has scrolled out of it.
+    return processor.isIdle() && vuValue <= scale.minVU && peakHoldVU <= scale.minVU && !peakHitDisplay
+        && (!showHistory() || history.quietColumns >= history.image.getWidth())
+        && (!showSpectrum() || isSpectrumAtRest())
+        && (!showGoniometer() || (!goniometer.fading && goniometer.correlation == 0.0f));
+}
+
+bool ViaUAudioProcessorEditor::isSpectrumAtRest() const noexcept
+{
+    for (int b = 0; b < numBands; ++b)
+        if (bandLevels[(size_t)b] > SpectrumAnalyser::floorDb)
+            return false;
+
+    return true;
 }
 
-void ViaUAudioProcessorEditor::timerCallback()
+// The scale parameters can change at any time; everything laid out along the scale is
+// rebuilt when they do, and the history restarts.
+void ViaUAudioProcessorEditor::updateScale()
 {
-    vuValue = processor.getCurrentVU();
+    const auto newScale = processor.getScale();
+    if (newScale == scale)
+        return;
+
+    scale = newScale;
+    peakHoldVU = juce::jlimit(scale.minVU, scale.maxVU, peakHoldVU);
+    ledOverlay = {};
+    needleBackground = {};
+    channelBackground = {};
+    historyOverlay = {};
+    history = {};
     repaint();
 }
 
+void ViaUAudioProcessorEditor::updateMeter()
+{
+    const double nowMs = juce::Time::getMillisecondCounterHiRes();
+    const float elapsedSeconds = lastFrameMs > 0.0 ? (float)((nowMs - lastFrameMs) * 0.001) : 0.0f;
+    lastFrameMs = nowMs;
+
+    updateScale();
+    prepareHistory();
+
+    // Fold every block published since the last frame, so short peaks are not lost.
+    float frameMaxVU = scale.minVU;
+    bool anySnapshot = false;
+    bool frameHit = false;
+
+    for (int num; (num = processor.popSnapshots(drainBuffer.data(), (int)drainBuffer.size())) > 0;)
+    {
+        for (int i = 0; i < num; ++i)
+        {
+            const auto& snapshot = drainBuffer[(size_t)i];
+            frameMaxVU = juce::jmax(frameMaxVU, snapshot.vu);
+            frameHit = frameHit || snapshot.peakHit;
+            addToHistory(snapshot);
+        }
+
+        const auto& latest = drainBuffer[(size_t)num - 1];
+        vuValue = latest.vu;
+        numChannels = latest.numChannels;
+        channelVU = latest.channelVU;
+        hasReference = latest.hasReference;
+        referenceVU = latest.referenceVU;
+        referenceDelta = latest.referenceDelta;
+        anySnapshot = true;
+    }
+
+    if (!anySnapshot)
+        frameMaxVU = vuValue;
+
+    // Idle blocks publish nothing, but still move the history on
+    closeHistoryColumns(processor.getSamplesProcessed());
+    scrollHistory();
+
+    if (showSpectrum())
+    {
+        auto& spectrum = processor.getSpectrumAnalyser();
+        numBands = spectrum.getNumBands();
+
+        for (int b = 0; b < numBands; ++b)
+        {
+            bandLevels[(size_t)b] = spectrum.getBandLevel(b);
+            bandCentres[(size_t)b] = spectrum.getBandCentre(b);
+        }
+    }
+
+    if (showGoniometer())
+        updateGoniometer(nowMs, elapsedSeconds);
+
+    if (frameMaxVU >= peakHoldVU)
+    {
+        peakHoldVU = frameMaxVU;
+        peakHoldUntilMs = nowMs + peakHoldMs;
+    }
+    else if (nowMs >= peakHoldUntilMs)
+    {
+        peakHoldVU = juce::jmax(frameMaxVU, peakHoldVU - peakReleasePerSecond * elapsedSeconds);
+    }
+
+    if (frameHit)
+        peakHitUntilMs = nowMs + peakHitMs;
+    peakHitDisplay = nowMs < peakHitUntilMs;
+
+    updateReadout();
+    repaintChangedRegions();
+
+   #if VIAU_ENABLE_PROFILING
+    if (showProfiler)
+        updateProfilerOverlay();
+   #endif
+}
+
+void ViaUAudioProcessorEditor::updateReadout()
+{
+    juce::String text;
+
+    auto toText = [](float db)
+        {
+            return std::isfinite(db) ? juce::String(db, 1) : juce::String("-inf");
+        };
+
+    if (hasReference)
+        text << "Ref " << juce::String(referenceVU, 1) << " VU   Diff "
+             << (referenceDelta > 0.0f ? "+" : "") << juce::String(referenceDelta, 1) << " dB";
+
+    if (processor.isLoudnessEnabled())
+    {
+        auto& loudness = processor.getLoudnessMeter();
+        if (text.isNotEmpty())
+            text << "\n";
+
+        text << "M " << toText(loudness.getMomentary())
+             << "  S " << toText(loudness.getShortTerm())
+             << "  I " << toText(loudness.getIntegrated()) << " LUFS"
+             << "   LRA " << juce::String(loudness.getLoudnessRange(), 1) << " LU";
+    }
+
+    if (processor.isTruePeakEnabled())
+    {
+        auto& truePeak = processor.getTruePeakDetector();
+        const int numTruePeakChannels = juce::jlimit(1, TruePeakDetector::maxChannels, numChannels);
+        float maxHold = 0.0f;
+
+        for (int ch = 0; ch < numTruePeakChannels; ++ch)
+        {
+            auto& hold = truePeakHold[(size_t)ch];
+            hold = juce::jmax(hold, truePeak.popChannelPeak(ch));
+            maxHold = juce::jmax(maxHold, hold);
+        }
+
+        auto dbtp = [&](float linear)
+            {
+                return toText(linear > 0.0f ? juce::Decibels::gainToDecibels(linear) : LoudnessMeter::noValue);
+            };
+
+        if (text.isNotEmpty())
+            text << "\n";
+
+        text << "TP ";
+        if (numTruePeakChannels == 2)
+            text << "L " << dbtp(truePeakHold[0]) << "  R " << dbtp(truePeakHold[1]);
+        else if (numTruePeakChannels == 1)
+            text << dbtp(maxHold);
+        else
+            text << "max " << dbtp(maxHold);
+        text << " dBTP    Clips " << juce::String((juce::int64)truePeak.getClipCount());
+    }
+
+    // The worker could not keep up and some audio went unanalysed
+    if (const auto dropped = processor.getNumDroppedAnalysisBlocks(); dropped > 0 && text.isNotEmpty())
+        text << "   (" << juce::String(dropped) << " blocks skipped)";
+
+    if (text != readoutText)
+    {
+        readoutText = text;
+        repaint(readoutBounds);
+    }
+}
+
+void ViaUAudioProcessorEditor::mouseDown(const juce::MouseEvent& e)
+{
+   #if VIAU_ENABLE_PROFILING
+    if (e.mods.isPopupMenu())
+    {
+        showProfilerMenu();
+        return;
+    }
+   #endif
+
+    if (readoutBounds.contains(e.getPosition()))
+    {
+        truePeakHold.fill(0.0f);
+        processor.getTruePeakDetector().resetClipCount();
+        processor.getLoudnessMeter().requestReset();
+    }
+}
+
+#if VIAU_ENABLE_PROFILING
+void ViaUAudioProcessorEditor::showProfilerMenu()
+{
+    juce::PopupMenu menu;
+    menu.addItem("Show processBlock profile", true, showProfiler, [this]
+        {
+            showProfiler = !showProfiler;
+            profilerText.clear();
+            repaint(profilerBounds);
+        });
+    menu.addItem("Reset profile", [this] { processor.getProfiler().requestReset(); });
+    menu.addItem("Save profile...", [this]
+        {
+            profileChooser = std::make_unique<juce::FileChooser>("Save processBlock profile",
+                juce::File::getSpecialLocation(juce::File::userDocumentsDirectory).getChildFile("ViaU-profile.txt"), "*.txt");
+
+            profileChooser->launchAsync(juce::FileBrowserComponent::saveMode | juce::FileBrowserComponent::warnAboutOverwriting,
+                [this](const juce::FileChooser& chooser)
+                {
+                    const auto file = chooser.getResult();
+                    if (file != juce::File())
+                        processor.getProfiler().writeToFile(file);
+                });
+        });
+
+    menu.showMenuAsync(juce::PopupMenu::Options().withTargetComponent(this));
+}
+
+void ViaUAudioProcessorEditor::updateProfilerOverlay()
+{
+    const auto stats = processor.getProfiler().getStats();
+    auto us = [](double ns) { return juce::String(ns * 0.001, 1); };
+
+    juce::String text;
+    text << "process " << us(stats.meanNs) << " / p99 " << us(stats.getPercentileNs(99.0))
+         << " / max " << us(stats.worstNs) << " us\n"
+         << "budget " << juce::String(stats.meanBudgetRatio * 100.0, 2) << " % / max "
+         << juce::String(stats.worstBudgetRatio * 100.0, 2) << " %\n";
+
+    // The shared frame scheduler, across every open editor in the process
+    const auto render = renderService->getStats();
+    text << "render " << juce::String(render.framesPerSecond, 0) << " fps / " << juce::String(render.meanFrameMs, 2)
+         << " ms / max " << juce::String(render.maxFrameMs, 2) << " ms, " << render.numShowing << " of "
+         << render.numClients << " showing";
+
+    if (text != profilerText)
+    {
+        profilerText = text;
+        repaint(profilerBounds);
+    }
+}
+#endif
+
+juce::Rectangle<int> ViaUAudioProcessorEditor::getHistoryArea() const
+{
+    return getLedOutline(meterBounds).reduced(4.0f).toNearestInt();
+}
+
+void ViaUAudioProcessorEditor::prepareHistory()
+{
+    const auto area = getHistoryArea();
+    const float scale = (float)juce::Component::getApproximateScaleFactorForComponent(this);
+    const double sampleRate = processor.getSampleRate();
+
+    if (history.image.isValid() && history.area == area && history.scale == scale && history.sampleRate == sampleRate)
+        return;
+
+    history = {};
+    history.area = area;
+    history.scale = scale;
+    history.sampleRate = sampleRate;
+
+    if (area.isEmpty() || sampleRate <= 0.0)
+        return;
+
+    // One tile per physical pixel column, so scrolling is a whole-pixel move at any scale
+    const int width = juce::jmax(1, juce::roundToInt((float)area.getWidth() * scale));
+    const int height = juce::jmax(1, juce::roundToInt((float)area.getHeight() * scale));
+    history.image = juce::Image(juce::Image::RGB, width, height, false);
+    history.samplesPerColumn = historySeconds * sampleRate / (double)width;
+    history.finished.reserve((size_t)width);
+
+    juce::Graphics g(history.image);
+    g.fillAll(juce::Colours::black);
+}
+
+void ViaUAudioProcessorEditor::addToHistory(const MeterSnapshot& snapshot)
+{
+    if (!history.image.isValid())
+        return;
+
+    closeHistoryColumns(snapshot.samplePosition);
+
+    auto& tile = history.openTile;
+    const float peakVU = scale.fromLinear(snapshot.peak);
+
+    tile.minVU = juce::jmin(tile.minVU, snapshot.vu);
+    tile.maxVU = juce::jmax(tile.maxVU, snapshot.vu);
+    tile.peakVU = juce::jmax(tile.peakVU, peakVU);
+    tile.peakHit = tile.peakHit || snapshot.peakHit;
+    tile.hasData = true;
+}
+
+// Finishes every column that ends at or before samplePosition. Columns no block was published
+// for (idle input) are finished empty, i.e. at the bottom of the scale.
+void ViaUAudioProcessorEditor::closeHistoryColumns(juce::int64 samplePosition)
+{
+    if (!history.image.isValid())
+        return;
+
+    const auto column = (juce::int64)((double)samplePosition / history.samplesPerColumn);
+    const auto numClosed = column - history.openColumn;
+
+    // First block, or the processor was prepared again and restarted its count
+    if (history.openColumn < 0 || numClosed < 0)
+    {
+        history.openColumn = column;
+        return;
+    }
+
+    if (numClosed == 0)
+        return;
+
+    const auto width = (juce::int64)history.image.getWidth();
+    if (numClosed <= width)
+        history.finished.push_back(history.openTile);
+
+    for (auto i = juce::jmin(numClosed - 1, width); --i >= 0;)
+        history.finished.push_back({});
+
+    history.openTile = {};
+    history.openColumn = column;
+}
+
+void ViaUAudioProcessorEditor::scrollHistory()
+{
+    auto& finished = history.finished;
+    if (finished.empty())
+        return;
+
+    auto& image = history.image;
+    const int width = image.getWidth();
+    const int numNew = juce::jmin((int)finished.size(), width);
+
+    if (numNew < width)
+        image.moveImageSection(0, 0, numNew, 0, width - numNew, image.getHeight());
+
+    {
+        juce::Graphics g(image);
+        for (int i = 0; i < numNew; ++i)
+            drawHistoryColumn(g, width - numNew + i, finished[finished.size() - (size_t)(numNew - i)]);
+    }
+
+    for (const auto& tile : finished)
+        history.quietColumns = tile.hasData && (tile.maxVU > scale.minVU || tile.peakVU > scale.minVU) ? 0 : history.quietColumns + 1;
+
+    finished.clear();
+
+    if (showHistory())
+        repaint(history.area);
+}
+
+// Column x of the history image: a dim body up to the lowest VU in the tile, the min..max
+// range in the level colour, and the sample peak as a dot.
+void ViaUAudioProcessorEditor::drawHistoryColumn(juce::Graphics& g, int x, const HistoryTile& tile)
+{
+    const int height = history.image.getHeight();
+    g.setColour(juce::Colours::black);
+    g.fillRect(x, 0, 1, height);
+
+    if (!tile.hasData)
+        return;
+
+    auto yOf = [this, height](float vu) { return juce::roundToInt((1.0f - scale.toNorm(vu)) * (float)(height - 1)); };
+    const int yMin = yOf(tile.minVU);
+    const int yMax = yOf(tile.maxVU);
+
+    juce::Colour colour;
+    if (tile.peakHit)
+        colour = juce::Colours::red;
+    else if (tile.maxVU <= scale.getCautionVU())
+        colour = juce::Colours::green;
+    else if (tile.maxVU <= scale.getWarningVU())
+        colour = juce::Colours::orange;
+    else
+        colour = juce::Colours::red;
+
+    if (tile.minVU > scale.minVU)
+    {
+        g.setColour(colour.withMultipliedBrightness(0.45f));
+        g.fillRect(x, yMin, 1, height - yMin);
+    }
+
+    g.setColour(colour);
+    g.fillRect(x, yMax, 1, juce::jmax(1, yMin - yMax + 1));
+
+    if (tile.peakVU > scale.minVU)
+    {
+        g.setColour(juce::Colours::white.withAlpha(0.8f));
+        g.fillRect(x, yOf(tile.peakVU), 1, 1);
+    }
+}
+
+ViaUAudioProcessorEditor::GoniometerLayout ViaUAudioProcessorEditor::getGoniometerLayout(juce::Rectangle<float> bounds) const
+{
+    auto area = getLedOutline(bounds);
+    GoniometerLayout layout;
+    layout.scope = area.removeFromLeft(area.getHeight());
+    area.removeFromLeft(8.0f);
+    layout.correlation = area.removeFromTop(26.0f);
+    layout.vu = area;
+    return layout;
+}
+
+void ViaUAudioProcessorEditor::updateGoniometer(double nowMs, float elapsedSeconds)
+{
+    const auto area = getGoniometerLayout(meterBounds).scope.reduced(4.0f).toNearestInt();
+    const float scale = (float)juce::Component::getApproximateScaleFactorForComponent(this);
+    auto& image = goniometer.image;
+
+    if (!image.isValid() || goniometer.area != area || goniometer.scale != scale)
+    {
+        image = juce::Image(juce::Image::ARGB,
+            juce::jmax(1, juce::roundToInt((float)area.getWidth() * scale)),
+            juce::jmax(1, juce::roundToInt((float)area.getHeight() * scale)), true);
+        goniometer.area = area;
+        goniometer.scale = scale;
+        goniometer.fading = false;
+    }
+
+    auto& meter = processor.getCorrelationMeter();
+    goniometer.correlation = meter.getCorrelation();
+
+    if (goniometer.fading)
+    {
+        image.multiplyAllAlphas(std::pow(0.5f, elapsedSeconds / goniometerHalfLifeSeconds));
+        goniometer.imageChanged = true;
+    }
+
+    int numPlotted = 0;
+    {
+        juce::Image::BitmapData pixels(image, juce::Image::BitmapData::readWrite);
+        const float halfWidth = (float)(image.getWidth() - 1) * 0.5f;
+        const float halfHeight = (float)(image.getHeight() - 1) * 0.5f;
+        const auto colour = juce::Colours::lightgreen;
+
+        for (int num; (num = meter.popPoints(goniometer.points.data(), (int)goniometer.points.size())) > 0;)
+        {
+            for (int i = 0; i < num; ++i)
+            {
+                const auto& point = goniometer.points[(size_t)i];
+                const int x = juce::roundToInt((1.0f + point.x) * halfWidth);
+                const int y = juce::roundToInt((1.0f - point.y) * halfHeight);
+
+                if (juce::isPositiveAndBelow(x, image.getWidth()) && juce::isPositiveAndBelow(y, image.getHeight()))
+                    pixels.setPixelColour(x, y, colour);
+            }
+
+            numPlotted += num;
+        }
+    }
+
+    if (numPlotted > 0)
+    {
+        goniometer.lastPointMs = nowMs;
+        goniometer.fading = true;
+        goniometer.imageChanged = true;
+    }
+    else if (goniometer.fading && nowMs - goniometer.lastPointMs > goniometerClearMs)
+    {
+        image.clear(image.getBounds());
+        goniometer.fading = false;
+        goniometer.imageChanged = true;
+    }
+}
+
+void ViaUAudioProcessorEditor::repaintChangedRegions()
+{
+    // The history repaints itself as it scrolls
+    if (showHistory())
+        return;
+
+    const bool hitChanged = peakHitDisplay != drawnPeakHit;
+    juce::Rectangle<float> dirty;
+
+    if (showGoniometer())
+    {
+        const auto layout = getGoniometerLayout(meterBounds);
+        const auto vuOutline = getLedOutline(layout.vu);
+        const bool correlationMoved = std::abs(goniometer.correlation - goniometer.drawnCorrelation) * 0.5f
+                                          * layout.correlation.getWidth() >= minVisibleChange;
+        const bool vuMoved = std::abs(scale.toNorm(vuValue) - scale.toNorm(drawnVU)) * vuOutline.getWidth() >= minVisibleChange
+                          || std::abs(scale.toNorm(peakHoldVU) - scale.toNorm(drawnPeakHoldVU)) * vuOutline.getWidth() >= minVisibleChange
+                          || std::abs(scale.toNorm(referenceVU) - scale.toNorm(drawnReferenceVU)) * vuOutline.getWidth() >= minVisibleChange
+                          || hitChanged || hasReference != drawnHasReference;
+
+        if (goniometer.imageChanged)
+            dirty = layout.scope;
+        if (correlationMoved)
+            dirty = dirty.getUnion(layout.correlation);
+        if (vuMoved)
+            dirty = dirty.getUnion(layout.vu);
+
+        goniometer.imageChanged = false;
+        goniometer.drawnCorrelation = goniometer.correlation;
+        drawnVU = vuValue;
+        drawnPeakHoldVU = peakHoldVU;
+        drawnPeakHit = peakHitDisplay;
+        drawnHasReference = hasReference;
+        drawnReferenceVU = referenceVU;
+
+        if (!dirty.isEmpty())
+            repaint(dirty.getSmallestIntegerContainer());
+        return;
+    }
+
+    if (showSpectrum())
+    {
+        // Like the channel bars: any visible change repaints the bar area
+        const auto outline = getLedOutline(meterBounds);
+        const float height = outline.getHeight();
+        bool moved = numBands != drawnNumBands;
+
+        for (int b = 0; b < numBands && !moved; ++b)
+            moved = std::abs(dbToNorm(bandLevels[(size_t)b]) - dbToNorm(drawnBandLevels[(size_t)b])) * height >= minVisibleChange;
+
+        if (!moved)
+            return;
+
+        // The band labels depend on the band layout
+        if (numBands != drawnNumBands)
+            spectrumBackground = {};
+
+        drawnNumBands = numBands;
+        drawnBandLevels = bandLevels;
+        repaint(outline.getSmallestIntegerContainer());
+        return;
+    }
+
+    if (showChannelBars())
+    {
+        // Any visible column change repaints the bar area; it is a handful of batched fills
+        const auto outline = getLedOutline(meterBounds);
+        const float height = outline.getHeight();
+        bool moved = hitChanged || numChannels != drawnNumChannels;
+
+        for (int ch = 0; ch < numChannels && !moved; ++ch)
+            moved = std::abs(scale.toNorm(channelVU[(size_t)ch]) - scale.toNorm(drawnChannelVU[(size_t)ch])) * height >= minVisibleChange;
+
+        if (!moved)
+            return;
+
+        dirty = outline;
+    }
+    else if (displayModeBox.getSelectedId() == 1)
+    {
+        const auto outline = getLedOutline(meterBounds);
+        const float width = outline.getWidth();
+        const bool vuMoved = std::abs(scale.toNorm(vuValue) - scale.toNorm(drawnVU)) * width >= minVisibleChange;
+        const bool holdMoved = std::abs(scale.toNorm(peakHoldVU) - scale.toNorm(drawnPeakHoldVU)) * width >= minVisibleChange;
+        const bool referenceMoved = hasReference != drawnHasReference
+                                 || std::abs(scale.toNorm(referenceVU) - scale.toNorm(drawnReferenceVU)) * width >= minVisibleChange;
+
+        if (!vuMoved && !holdMoved && !hitChanged && !referenceMoved)
+            return;
+
+        auto span = [&](float vuA, float vuB, float margin)
+            {
+                const float x1 = outline.getX() + width * juce::jmin(scale.toNorm(vuA), scale.toNorm(vuB));
+                const float x2 = outline.getX() + width * juce::jmax(scale.toNorm(vuA), scale.toNorm(vuB));
+                return outline.withLeft(x1 - margin).withRight(x2 + margin).getIntersection(outline);
+            };
+
+        // Above the caution zone the fill colour follows the level, and a peak hit recolours the whole bar
+        if (hitChanged || (vuMoved && juce::jmax(vuValue, drawnVU) > scale.getCautionVU()))
+            dirty = outline;
+        else if (vuMoved)
+            dirty = span(vuValue, drawnVU, 8.0f);
+
+        if (holdMoved)
+            dirty = dirty.getUnion(span(peakHoldVU, drawnPeakHoldVU, 2.0f));
+
+        // The reference bar is drawn over the main fill, so its change is enough
+        if (referenceMoved)
+            dirty = dirty.getUnion(span(hasReference ? referenceVU : scale.minVU, drawnHasReference ? drawnReferenceVU : scale.minVU, 8.0f));
+    }
+    else
+    {
+        const auto dial = getNeedleDial(meterBounds);
+        const auto c = dial.getCentre();
+        const float rNeedle = dial.getWidth() * 0.45f;
+        const float rHold = dial.getWidth() * 0.48f;
+        const bool vuMoved = std::abs(scale.toAngle(vuValue) - scale.toAngle(drawnVU)) * rNeedle >= minVisibleChange;
+        const bool holdMoved = std::abs(scale.toAngle(peakHoldVU) - scale.toAngle(drawnPeakHoldVU)) * rHold >= minVisibleChange;
+        const bool referenceMoved = hasReference != drawnHasReference
+                                 || std::abs(scale.toAngle(referenceVU) - scale.toAngle(drawnReferenceVU)) * rNeedle >= minVisibleChange;
+
+        if (!vuMoved && !holdMoved && !hitChanged && !referenceMoved)
+            return;
+
+        auto needleArea = [&](float vu)
+            {
+                return juce::Rectangle<float>(c, pointOnDial(c, rNeedle, scale.toAngle(vu))).expanded(5.0f);
+            };
+
+        auto holdArea = [&](float vu)
+            {
+                const float angle = scale.toAngle(vu);
+                return juce::Rectangle<float>(pointOnDial(c, rHold - 10.0f, angle), pointOnDial(c, rHold, angle)).expanded(2.0f);
+            };
+
+        if (vuMoved || hitChanged)
+            dirty = needleArea(vuValue).getUnion(needleArea(drawnVU));
+
+        if (holdMoved)
+            dirty = dirty.getUnion(holdArea(peakHoldVU)).getUnion(holdArea(drawnPeakHoldVU));
+
+        // The reference needle is shorter than the main one, so the same areas cover it
+        if (referenceMoved)
+            dirty = dirty.getUnion(needleArea(referenceVU)).getUnion(needleArea(drawnReferenceVU));
+    }
+
+    drawnVU = vuValue;
+    drawnPeakHoldVU = peakHoldVU;
+    drawnPeakHit = peakHitDisplay;
+    drawnHasReference = hasReference;
+    drawnReferenceVU = referenceVU;
+    drawnNumChannels = numChannels;
+    drawnChannelVU = channelVU;
+
+    repaint(dirty.getSmallestIntegerContainer());
+}
+
 juce::Colour ViaUAudioProcessorEditor::interpolateColour(float vu, float vuStart, float vuEnd, juce::Colour startCol, juce::Colour endCol)
 {
     float t = juce::jlimit(0.0f, 1.0f, (vu - vuStart) / (vuEnd - vuStart));
@@ -35,110 +760,389 @@ void ViaUAudioProcessorEditor::paint(juce::Graphics& g)
 {
     g.fillAll(juce::Colours::black);
 
-    auto r = getLocalBounds().toFloat().reduced(12.0f);
-    auto meterBounds = r.removeFromTop(r.getHeight() - 40.0f);
+    if (readoutText.isNotEmpty())
+    {
+        g.setColour(juce::Colours::white.withAlpha(0.8f));
+        const int numLines = juce::StringArray::fromLines(readoutText).size();
+        g.setFont(juce::Font(numLines > 2 ? 12.0f : 13.0f));
+        g.drawFittedText(readoutText, readoutBounds, juce::Justification::centredLeft, numLines);
+    }
 
     int mode = displayModeBox.getSelectedId();
-    if (mode == 1)
+    if (showChannelBars())
+        drawChannelBars(g, meterBounds);
+    else if (showHistory())
+        drawHistory(g, meterBounds);
+    else if (showSpectrum())
+        drawSpectrum(g, meterBounds);
+    else if (showGoniometer())
+        drawGoniometer(g, meterBounds);
+    else if (mode == 1)
         drawLedMeter(g, meterBounds, vuValue);
     else
         drawNeedleMeter(g, meterBounds, vuValue);
+
+   #if VIAU_ENABLE_PROFILING
+    if (showProfiler && profilerText.isNotEmpty())
+    {
+        g.setColour(juce::Colours::black.withAlpha(0.7f));
+        g.fillRect(profilerBounds);
+        g.setColour(juce::Colours::yellow);
+        g.setFont(juce::Font(12.0f));
+        g.drawFittedText(profilerText, profilerBounds.reduced(4, 2), juce::Justification::centredRight, 3);
+    }
+   #endif
+}
+
+// Renders a static layer once into an image matching the target bounds and the context's
+// pixel scale, then blits it. The cache is rebuilt only if either of those changes.
+template <typename DrawFn>
+void ViaUAudioProcessorEditor::drawCachedLayer(juce::Graphics& g, CachedLayer& layer, juce::Rectangle<float> bounds, DrawFn&& drawLayer)
+{
+    const auto area = bounds.getSmallestIntegerContainer();
+    const float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+
+    if (!layer.image.isValid() || layer.area != area || layer.scale != scale)
+    {
+        layer.image = juce::Image(juce::Image::ARGB,
+            juce::jmax(1, juce::roundToInt((float)area.getWidth() * scale)),
+            juce::jmax(1, juce::roundToInt((float)area.getHeight() * scale)), true);
+        layer.area = area;
+        layer.scale = scale;
+
+        juce::Graphics lg(layer.image);
+        lg.addTransform(juce::AffineTransform::translation((float)-area.getX(), (float)-area.getY()).scaled(scale));
+        drawLayer(lg);
+    }
+
+    g.drawImage(layer.image, area.toFloat());
 }
 
 // --- drawLedMeter with gradient ---
 void ViaUAudioProcessorEditor::drawLedMeter(juce::Graphics& g, juce::Rectangle<float> bounds, float vu)
 {
-    auto meterBounds = bounds.reduced(6.0f);
-    auto outline = meterBounds.withHeight(meterBounds.getHeight() - 6.0f);
+    auto outline = getLedOutline(bounds);
+
+    drawCachedLayer(g, ledBackground, outline, [&](juce::Graphics& lg)
+        {
+            lg.setColour(juce::Colours::dimgrey);
+            lg.fillRoundedRectangle(outline, 8.0f);
+        });
 
-    g.setColour(juce::Colours::dimgrey);
-    g.fillRoundedRectangle(outline, 8.0f);
+    auto fill = outline.withWidth(outline.getWidth() * scale.toNorm(vu));
 
-    const float norm = juce::jlimit(0.0f, 1.0f, (vu + 20.0f) / 23.0f);
-    auto fill = outline.withWidth(outline.getWidth() * norm);
+    const float cautionVU = scale.getCautionVU();
+    const float warningVU = scale.getWarningVU();
 
     juce::Colour fillColor;
-    if (vu <= -6.0f)
+    if (vu <= cautionVU)
         fillColor = juce::Colours::green;
-    else if (vu <= -3.0f)
-        fillColor = interpolateColour(vu, -6.0f, -3.0f, juce::Colours::yellow, juce::Colours::orange);
+    else if (vu <= warningVU)
+        fillColor = interpolateColour(vu, cautionVU, warningVU, juce::Colours::yellow, juce::Colours::orange);
     else
-        fillColor = interpolateColour(vu, -3.0f, 3.0f, juce::Colours::orange, juce::Colours::red);
+        fillColor = interpolateColour(vu, warningVU, scale.maxVU, juce::Colours::orange, juce::Colours::red);
 
-    if (processor.isPeakHit())
+    if (peakHitDisplay)
         fillColor = juce::Colours::red;
 
     g.setColour(fillColor);
     g.fillRoundedRectangle(fill.reduced(2.0f), 6.0f);
 
+    // Reference bus: a narrower bar along the bottom edge, over the main fill
+    if (hasReference)
+    {
+        auto reference = outline.withWidth(outline.getWidth() * scale.toNorm(referenceVU)).reduced(2.0f);
+        g.setColour(juce::Colours::lightskyblue.withAlpha(0.85f));
+        g.fillRect(reference.removeFromBottom(reference.getHeight() * 0.3f));
+    }
+
+    // Peak hold marker
+    const float holdX = outline.getX() + outline.getWidth() * scale.toNorm(peakHoldVU);
+    g.setColour(juce::Colours::white.withAlpha(0.8f));
+    g.fillRect(juce::Rectangle<float>(holdX - 1.0f, outline.getY() + 2.0f, 2.0f, outline.getHeight() - 4.0f));
+
     // Ticks
-    g.setColour(juce::Colours::white.withAlpha(0.3f));
-    g.setFont(juce::Font(12.0f));
-    for (float tickVU : { -20.0f, -10.0f, -5.0f, -3.0f, 0.0f, 3.0f })
+    auto tickArea = outline.withTrimmedTop(-4.0f).withTrimmedBottom(-16.0f).expanded(10.0f, 0.0f);
+    drawCachedLayer(g, ledOverlay, tickArea, [&](juce::Graphics& lg)
+        {
+            lg.setColour(juce::Colours::white.withAlpha(0.3f));
+            lg.setFont(juce::Font(12.0f));
+            for (float tickVU : getScaleTicks(scale))
+            {
+                float x = outline.getX() + outline.getWidth() * scale.toNorm(tickVU);
+                lg.drawVerticalLine((int)std::round(x), outline.getY() - 4.0f, outline.getBottom() + 4.0f);
+                lg.drawText(juce::String(tickVU, 0), (int)x - 10, (int)outline.getBottom() + 2, 20, 14, juce::Justification::centred);
+            }
+        });
+}
+
+// --- drawChannelBars: one column per channel for multichannel buses ---
+void ViaUAudioProcessorEditor::drawChannelBars(juce::Graphics& g, juce::Rectangle<float> bounds)
+{
+    auto outline = getLedOutline(bounds);
+    auto area = outline.reduced(4.0f);
+    auto levelY = [&](float vu) { return area.getBottom() - area.getHeight() * scale.toNorm(vu); };
+
+    drawCachedLayer(g, channelBackground, outline, [&](juce::Graphics& lg)
+        {
+            lg.setColour(juce::Colours::dimgrey);
+            lg.fillRoundedRectangle(outline, 8.0f);
+
+            lg.setColour(juce::Colours::white.withAlpha(0.3f));
+            for (float tickVU : getScaleTicks(scale, false))
+                lg.drawHorizontalLine((int)std::round(levelY(tickVU)), area.getX(), area.getRight());
+        });
+
+    // Split every column into colour zones and fill each zone as one rectangle list, so the
+    // number of draw calls stays constant however many channels there are.
+    juce::RectangleList<float> greens, oranges, reds;
+    const float columnWidth = area.getWidth() / (float)numChannels;
+    const float gap = juce::jmin(2.0f, columnWidth * 0.25f);
+    const float yOrange = levelY(scale.getCautionVU());
+    const float yRed = levelY(scale.getWarningVU());
+
+    for (int ch = 0; ch < numChannels; ++ch)
     {
-        float x = outline.getX() + outline.getWidth() * juce::jlimit(0.0f, 1.0f, (tickVU + 20.0f) / 23.0f);
-        g.drawVerticalLine((int)std::round(x), outline.getY() - 4.0f, outline.getBottom() + 4.0f);
-        g.drawText(juce::String(tickVU, 0), (int)x - 10, (int)outline.getBottom() + 2, 20, 14, juce::Justification::centred);
+        const float top = levelY(channelVU[(size_t)ch]);
+        auto bar = juce::Rectangle<float>(area.getX() + (float)ch * columnWidth, top,
+                                          columnWidth - gap, area.getBottom() - top);
+
+        greens.addWithoutMerging(bar.withTop(juce::jmax(top, yOrange)));
+        oranges.addWithoutMerging(bar.withTop(juce::jmax(top, yRed)).withBottom(yOrange));
+        reds.addWithoutMerging(bar.withBottom(yRed));
     }
+
+    g.setColour(juce::Colours::green);
+    g.fillRectList(greens);
+    g.setColour(juce::Colours::orange);
+    g.fillRectList(oranges);
+    g.setColour(juce::Colours::red);
+    g.fillRectList(reds);
 }
 
-// --- drawNeedleMeter with gradient arcs ---
-void ViaUAudioProcessorEditor::drawNeedleMeter(juce::Graphics& g, juce::Rectangle<float> bounds, float vu)
+// --- drawHistory: blits the scrolling history image between cached background and ticks ---
+void ViaUAudioProcessorEditor::drawHistory(juce::Graphics& g, juce::Rectangle<float> bounds)
 {
-    auto r = bounds.reduced(8.0f);
-    float size = juce::jmin(r.getWidth(), r.getHeight());
-    auto dial = juce::Rectangle<float>(0, 0, size, size).withCentre(r.getCentre());
+    auto outline = getLedOutline(bounds);
+    const auto area = outline.reduced(4.0f).toNearestInt().toFloat();
+    auto levelY = [&](float vu) { return area.getBottom() - area.getHeight() * scale.toNorm(vu); };
 
-    g.setColour(juce::Colours::dimgrey);
-    g.fillEllipse(dial);
-    g.setColour(juce::Colours::black);
-    g.fillEllipse(dial.reduced(6.0f));
+    drawCachedLayer(g, historyBackground, outline, [&](juce::Graphics& lg)
+        {
+            lg.setColour(juce::Colours::dimgrey);
+            lg.fillRoundedRectangle(outline, 8.0f);
+        });
+
+    if (history.image.isValid())
+        g.drawImage(history.image, area);
 
-    auto drawGradientArc = [&](float vuStart, float vuEnd, juce::Colour startCol, juce::Colour endCol)
+    drawCachedLayer(g, historyOverlay, outline, [&](juce::Graphics& lg)
         {
-            const int numSegments = 50;
-            for (int i = 0; i < numSegments; ++i)
+            lg.setColour(juce::Colours::white.withAlpha(0.3f));
+            lg.setFont(juce::Font(11.0f));
+            for (float tickVU : getScaleTicks(scale, false))
             {
-                float t1 = (float)i / numSegments;
-                float t2 = (float)(i + 1) / numSegments;
-                float vu1 = juce::jmap(t1, 0.0f, 1.0f, vuStart, vuEnd);
-                float vu2 = juce::jmap(t2, 0.0f, 1.0f, vuStart, vuEnd);
-
-                float angle1 = juce::degreesToRadians(juce::jmap(vu1, -20.0f, 3.0f, 230.0f, -50.0f));
-                float angle2 = juce::degreesToRadians(juce::jmap(vu2, -20.0f, 3.0f, 230.0f, -50.0f));
-
-                juce::Point<float> c = dial.getCentre();
-                float rOuter = dial.getWidth() * 0.48f;
-                float rInner = rOuter - 8.0f;
-
-                juce::Point<float> p1(c.x + rInner * std::cos(angle1), c.y + rInner * std::sin(angle1));
-                juce::Point<float> p2(c.x + rOuter * std::cos(angle1), c.y + rOuter * std::sin(angle1));
-                juce::Point<float> p3(c.x + rOuter * std::cos(angle2), c.y + rOuter * std::sin(angle2));
-                juce::Point<float> p4(c.x + rInner * std::cos(angle2), c.y + rInner * std::sin(angle2));
-
-                juce::Path segment;
-                segment.startNewSubPath(p1);
-                segment.lineTo(p2);
-                segment.lineTo(p3);
-                segment.lineTo(p4);
-                segment.closeSubPath();
-                g.setColour(startCol.interpolatedWith(endCol, (float)i / numSegments));
-                g.fillPath(segment);
+                const float y = levelY(tickVU);
+                lg.drawHorizontalLine((int)std::round(y), area.getX(), area.getRight());
+                lg.drawText(juce::String(tickVU, 0), (int)area.getX() + 2, (int)y - 12, 24, 12, juce::Justification::centredLeft);
             }
-        };
+        });
+}
+
+// --- drawSpectrum: one bar per octave or third-octave band ---
+void ViaUAudioProcessorEditor::drawSpectrum(juce::Graphics& g, juce::Rectangle<float> bounds)
+{
+    auto outline = getLedOutline(bounds);
+    auto area = outline.reduced(4.0f);
+    auto labelArea = area.removeFromBottom(12.0f);
+    auto levelY = [&](float db) { return area.getBottom() - area.getHeight() * dbToNorm(db); };
+
+    if (numBands <= 0)
+        return;
 
-    drawGradientArc(-20.0f, -6.0f, juce::Colours::green, juce::Colours::green);
-    drawGradientArc(-6.0f, -3.0f, juce::Colours::yellow, juce::Colours::orange);
-    drawGradientArc(-3.0f, 3.0f, juce::Colours::orange, juce::Colours::red);
+    const float columnWidth = area.getWidth() / (float)numBands;
+    const float gap = juce::jmin(2.0f, columnWidth * 0.25f);
+
+    drawCachedLayer(g, spectrumBackground, outline, [&](juce::Graphics& lg)
+        {
+            lg.setColour(juce::Colours::dimgrey);
+            lg.fillRoundedRectangle(outline, 8.0f);
+
+            lg.setColour(juce::Colours::white.withAlpha(0.3f));
+            for (float db : { -12.0f, -24.0f, -36.0f, -48.0f, -60.0f })
+                lg.drawHorizontalLine((int)std::round(levelY(db)), area.getX(), area.getRight());
+
+            // Label the bands nearest a few familiar frequencies
+            lg.setFont(juce::Font(10.0f));
+            for (auto [hz, text] : { std::make_pair(63.0f, "63"), std::make_pair(250.0f, "250"), std::make_pair(1000.0f, "1k"),
+                                     std::make_pair(4000.0f, "4k"), std::make_pair(16000.0f, "16k") })
+            {
+                int nearest = 0;
+                for (int b = 1; b < numBands; ++b)
+                    if (std::abs(std::log2(bandCentres[(size_t)b] / hz)) < std::abs(std::log2(bandCentres[(size_t)nearest] / hz)))
+                        nearest = b;
+
+                if (std::abs(std::log2(bandCentres[(size_t)nearest] / hz)) < 0.25f)
+                {
+                    const float x = area.getX() + ((float)nearest + 0.5f) * columnWidth;
+                    lg.drawText(text, juce::Rectangle<float>(x - 14.0f, labelArea.getY(), 28.0f, labelArea.getHeight()),
+                                juce::Justification::centred);
+                }
+            }
+        });
+
+    // Same zone batching as the channel bars; the zones sit at 0 VU (the reference level) and -6 dBFS
+    juce::RectangleList<float> greens, oranges, reds;
+    const float yOrange = levelY(scale.referenceDbfs);
+    const float yRed = levelY(-6.0f);
+
+    for (int b = 0; b < numBands; ++b)
+    {
+        const float top = levelY(bandLevels[(size_t)b]);
+        auto bar = juce::Rectangle<float>(area.getX() + (float)b * columnWidth + gap * 0.5f, top,
+                                          columnWidth - gap, area.getBottom() - top);
+
+        greens.addWithoutMerging(bar.withTop(juce::jmax(top, yOrange)));
+        oranges.addWithoutMerging(bar.withTop(juce::jmax(top, yRed)).withBottom(yOrange));
+        reds.addWithoutMerging(bar.withBottom(yRed));
+    }
+
+    g.setColour(juce::Colours::green);
+    g.fillRectList(greens);
+    g.setColour(juce::Colours::orange);
+    g.fillRectList(oranges);
+    g.setColour(juce::Colours::red);
+    g.fillRectList(reds);
+}
+
+// --- drawGoniometer: persistence scope, correlation bar and LED VU ---
+void ViaUAudioProcessorEditor::drawGoniometer(juce::Graphics& g, juce::Rectangle<float> bounds)
+{
+    const auto layout = getGoniometerLayout(bounds);
+    const auto scopeArea = layout.scope.reduced(4.0f);
+
+    drawCachedLayer(g, goniometerBackground, layout.scope, [&](juce::Graphics& lg)
+        {
+            lg.setColour(juce::Colours::dimgrey);
+            lg.fillRoundedRectangle(layout.scope, 8.0f);
+            lg.setColour(juce::Colours::black);
+            lg.fillRect(scopeArea);
+
+            // M vertical, S horizontal, L and R on the diagonals
+            const auto c = scopeArea.getCentre();
+            lg.setColour(juce::Colours::white.withAlpha(0.2f));
+            lg.drawLine(c.x, scopeArea.getY(), c.x, scopeArea.getBottom());
+            lg.drawLine(scopeArea.getX(), c.y, scopeArea.getRight(), c.y);
+            lg.drawLine(juce::Line<float>(scopeArea.getTopLeft(), scopeArea.getBottomRight()));
+            lg.drawLine(juce::Line<float>(scopeArea.getTopRight(), scopeArea.getBottomLeft()));
+
+            lg.setColour(juce::Colours::white.withAlpha(0.5f));
+            lg.setFont(juce::Font(10.0f));
+            lg.drawText("L", scopeArea.withSize(12.0f, 12.0f), juce::Justification::centred);
+            lg.drawText("R", scopeArea.withLeft(scopeArea.getRight() - 12.0f).withHeight(12.0f), juce::Justification::centred);
+        });
+
+    if (goniometer.image.isValid())
+        g.drawImage(goniometer.image, goniometer.area.toFloat());
+
+    // Correlation: -1 .. +1, filled from the centre, red when out of phase
+    const auto bar = layout.correlation.withTrimmedBottom(12.0f);
+    drawCachedLayer(g, correlationBackground, layout.correlation, [&](juce::Graphics& lg)
+        {
+            lg.setColour(juce::Colours::dimgrey);
+            lg.fillRoundedRectangle(bar, 4.0f);
+
+            lg.setColour(juce::Colours::white.withAlpha(0.3f));
+            lg.setFont(juce::Font(10.0f));
+            for (float value : { -1.0f, -0.5f, 0.0f, 0.5f, 1.0f })
+            {
+                const float x = bar.getX() + bar.getWidth() * (value + 1.0f) * 0.5f;
+                lg.drawVerticalLine((int)std::round(x), bar.getY(), bar.getBottom());
+                lg.drawText(juce::String(value, value == 0.0f ? 0 : 1), (int)x - 12, (int)bar.getBottom(), 24, 12,
+                            juce::Justification::centred);
+            }
+        });
+
+    const float centreX = bar.getCentreX();
+    const float valueX = bar.getX() + bar.getWidth() * (goniometer.correlation + 1.0f) * 0.5f;
+    g.setColour(goniometer.correlation < 0.0f ? juce::Colours::red : juce::Colours::green);
+    g.fillRect(juce::Rectangle<float>(juce::jmin(centreX, valueX), bar.getY() + 3.0f,
+                                      juce::jmax(2.0f, std::abs(valueX - centreX)), bar.getHeight() - 6.0f));
+
+    drawLedMeter(g, layout.vu, vuValue);
+}
+
+// --- drawNeedleMeter with gradient arcs ---
+void ViaUAudioProcessorEditor::drawNeedleMeter(juce::Graphics& g, juce::Rectangle<float> bounds, float vu)
+{
+    auto dial = getNeedleDial(bounds);
+
+    // Dial and gradient arcs never change between resizes
+    drawCachedLayer(g, needleBackground, dial, [&](juce::Graphics& lg)
+        {
+            lg.setColour(juce::Colours::dimgrey);
+            lg.fillEllipse(dial);
+            lg.setColour(juce::Colours::black);
+            lg.fillEllipse(dial.reduced(6.0f));
+
+            auto drawGradientArc = [&](float vuStart, float vuEnd, juce::Colour startCol, juce::Colour endCol)
+                {
+                    const int numSegments = 50;
+                    for (int i = 0; i < numSegments; ++i)
+                    {
+                        float t1 = (float)i / numSegments;
+                        float t2 = (float)(i + 1) / numSegments;
+                        float vu1 = juce::jmap(t1, 0.0f, 1.0f, vuStart, vuEnd);
+                        float vu2 = juce::jmap(t2, 0.0f, 1.0f, vuStart, vuEnd);
+
+                        float angle1 = scale.toAngle(vu1);
+                        float angle2 = scale.toAngle(vu2);
+
+                        juce::Point<float> c = dial.getCentre();
+                        float rOuter = dial.getWidth() * 0.48f;
+                        float rInner = rOuter - 8.0f;
+
+                        juce::Point<float> p1(c.x + rInner * std::cos(angle1), c.y + rInner * std::sin(angle1));
+                        juce::Point<float> p2(c.x + rOuter * std::cos(angle1), c.y + rOuter * std::sin(angle1));
+                        juce::Point<float> p3(c.x + rOuter * std::cos(angle2), c.y + rOuter * std::sin(angle2));
+                        juce::Point<float> p4(c.x + rInner * std::cos(angle2), c.y + rInner * std::sin(angle2));
+
+                        juce::Path segment;
+                        segment.startNewSubPath(p1);
+                        segment.lineTo(p2);
+                        segment.lineTo(p3);
+                        segment.lineTo(p4);
+                        segment.closeSubPath();
+                        lg.setColour(startCol.interpolatedWith(endCol, (float)i / numSegments));
+                        lg.fillPath(segment);
+                    }
+                };
+
+            drawGradientArc(scale.minVU, scale.getCautionVU(), juce::Colours::green, juce::Colours::green);
+            drawGradientArc(scale.getCautionVU(), scale.getWarningVU(), juce::Colours::yellow, juce::Colours::orange);
+            drawGradientArc(scale.getWarningVU(), scale.maxVU, juce::Colours::orange, juce::Colours::red);
+        });
 
     // Needle
     auto c = dial.getCentre();
     float rNeedle = dial.getWidth() * 0.45f;
-    float angle = juce::degreesToRadians(juce::jmap(vu, -20.0f, 3.0f, 230.0f, -50.0f));
-    juce::Point<float> needleTip(c.x + rNeedle * std::cos(angle),
-        c.y + rNeedle * std::sin(angle));
+    juce::Point<float> needleTip = pointOnDial(c, rNeedle, scale.toAngle(vu));
+
+    // Peak hold marker on the rim
+    const float holdAngle = scale.toAngle(peakHoldVU);
+    const float rHold = dial.getWidth() * 0.48f;
+    g.setColour(juce::Colours::white.withAlpha(0.8f));
+    g.drawLine(juce::Line<float>(pointOnDial(c, rHold - 10.0f, holdAngle), pointOnDial(c, rHold, holdAngle)), 2.0f);
+
+    // Reference bus: a shorter needle under the main one
+    if (hasReference)
+    {
+        const auto referenceTip = pointOnDial(c, rNeedle * 0.85f, scale.toAngle(referenceVU));
+        g.setColour(juce::Colours::lightskyblue);
+        g.drawLine(c.x, c.y, referenceTip.x, referenceTip.y, 2.0f);
+    }
 
-    g.setColour(processor.isPeakHit() ? juce::Colours::red : juce::Colours::white);
+    g.setColour(peakHitDisplay ? juce::Colours::red : juce::Colours::white);
     g.drawLine(c.x, c.y, needleTip.x, needleTip.y, 2.0f);
 
     // Center pin
@@ -1,29 +1,186 @@
 #pragma once
 #include <juce_gui_extra/juce_gui_extra.h>
 #include "PluginProcessor.h"
+#include "MeterRenderService.h"
 
-class ViaUAudioProcessorEditor : public juce::AudioProcessorEditor, private juce::Timer
+class ViaUAudioProcessorEditor : public juce::AudioProcessorEditor,
+    private MeterRenderService::Client
 {
 public:
     explicit ViaUAudioProcessorEditor(ViaUAudioProcessor&);
-    ~ViaUAudioProcessorEditor() override = default;
+    ~ViaUAudioProcessorEditor() override;
 
     void paint(juce::Graphics&) override;
     void resized() override;
+    void mouseDown(const juce::MouseEvent&) override;
 
 private:
-    void timerCallback() override;
+    // MeterRenderService::Client
+    juce::Component& getRenderComponent() override { return *this; }
+    void renderFrame() override { updateMeter(); }
+    bool isIdle() override;
+
+    // Called once per frame: drains the processor and repaints what visibly changed
+    void updateMeter();
+    void updateScale();
+    void repaintChangedRegions();
+
     void drawLedMeter(juce::Graphics& g, juce::Rectangle<float> bounds, float vu);
     void drawNeedleMeter(juce::Graphics& g, juce::Rectangle<float> bounds, float vu);
+    void drawChannelBars(juce::Graphics& g, juce::Rectangle<float> bounds);
+    void drawHistory(juce::Graphics& g, juce::Rectangle<float> bounds);
+    void drawSpectrum(juce::Graphics& g, juce::Rectangle<float> bounds);
+    void drawGoniometer(juce::Graphics& g, juce::Rectangle<float> bounds);
+    void updateReadout();
+    bool showChannelBars() const noexcept { return displayModeBox.getSelectedId() == 1 && numChannels > 2; }
+
+    // Static background layers, cached per size and pixel scale; cleared in resized()
+    struct CachedLayer
+    {
+        juce::Image image;
+        juce::Rectangle<int> area;
+        float scale = 0.0f;
+    };
+
+    template <typename DrawFn>
+    void drawCachedLayer(juce::Graphics& g, CachedLayer& layer, juce::Rectangle<float> bounds, DrawFn&& drawLayer);
+
+    CachedLayer ledBackground, ledOverlay, needleBackground, channelBackground, historyBackground, historyOverlay,
+                spectrumBackground, goniometerBackground, correlationBackground;
+
+    // Scrolling VU/peak history (display mode 3), historySeconds wide. Each image column is one
+    // tile: the min/max VU, max peak and peak hit of the blocks whose start fell into it. The
+    // image is kept at physical pixel resolution and is the history itself: once per frame it is
+    // shifted left by the number of finished tiles, and only those columns are drawn at the
+    // right edge. It is kept up to date in every mode, and restarts when the size or scale changes.
+    struct HistoryTile
+    {
+        float minVU = std::numeric_limits<float>::max();
+        float maxVU = std::numeric_limits<float>::lowest();
+        float peakVU = std::numeric_limits<float>::lowest();
+        bool peakHit = false;
+        bool hasData = false;
+    };
+
+    struct HistoryStrip
+    {
+        juce::Image image;
+        juce::Rectangle<int> area;
+        float scale = 0.0f;
+        double sampleRate = 0.0;
+        double samplesPerColumn = 0.0;
+        juce::int64 openColumn = -1;
+        HistoryTile openTile;
+        std::vector<HistoryTile> finished;
+        int quietColumns = 0;               // consecutive columns at the bottom of the scale
+    };
+
+    bool showHistory() const noexcept { return displayModeBox.getSelectedId() == 3; }
+    juce::Rectangle<int> getHistoryArea() const;
+    void prepareHistory();
+    void addToHistory(const MeterSnapshot& snapshot);
+    void closeHistoryColumns(juce::int64 samplePosition);
+    void scrollHistory();
+    void drawHistoryColumn(juce::Graphics& g, int x, const HistoryTile& tile);
+
+    HistoryStrip history;
+
+    // Band levels (dBFS) read from the processor's spectrum analyser each frame in spectrum mode
+    bool showSpectrum() const noexcept { return displayModeBox.getSelectedId() == ViaUAudioProcessor::spectrumDisplayMode + 1; }
+    bool isSpectrumAtRest() const noexcept;
+    int numBands = 0;
+    std::array<float, SpectrumAnalyser::maxBands> bandLevels {};
+    std::array<float, SpectrumAnalyser::maxBands> bandCentres {};
+
+    // Goniometer mode: vectorscope, correlation bar and the LED VU side by side. The scope is
+    // a persistence image at physical pixel resolution. Each frame its alpha is faded, and the
+    // points queued by the correlation meter since the last frame are plotted into it, so old
+    // points are never drawn again.
+    struct GoniometerLayout
+    {
+        juce::Rectangle<float> scope, correlation, vu;
+    };
+
+    struct Goniometer
+    {
+        juce::Image image;
+        juce::Rectangle<int> area;
+        float scale = 0.0f;
+        std::vector<CorrelationMeter::Point> points;
+        double lastPointMs = 0.0;
+        bool fading = false;                // the image holds points that have not faded out
+        bool imageChanged = false;
+        float correlation = 0.0f;
+        float drawnCorrelation = 0.0f;
+    };
+
+    bool showGoniometer() const noexcept { return displayModeBox.getSelectedId() == ViaUAudioProcessor::goniometerDisplayMode + 1; }
+    GoniometerLayout getGoniometerLayout(juce::Rectangle<float> bounds) const;
+    void updateGoniometer(double nowMs, float elapsedSeconds);
+
+    Goniometer goniometer;
 
     // Gradient helper
     juce::Colour interpolateColour(float vu, float vuStart, float vuEnd, juce::Colour startCol, juce::Colour endCol);
 
     ViaUAudioProcessor& processor;
+    VUScale scale;                      // from the processor's parameters, checked every frame
     float vuValue = -20.0f;
+    juce::Rectangle<float> meterBounds;
+
+    // Per-channel VU for multichannel buses, shown as one bar per channel in LED mode
+    int numChannels = 0;
+    std::array<float, MeterSnapshot::maxChannels> channelVU {};
+
+    // Reference (sidechain) bus, overlaid on the LED bar and the needle dial
+    bool hasReference = false;
+    float referenceVU = -20.0f;
+    float referenceDelta = 0.0f;
+
+    // Snapshots drained from the processor each frame, folded into peak hold / peak hit latch
+    std::vector<MeterSnapshot> drainBuffer;
+    float peakHoldVU = -20.0f;
+    bool peakHitDisplay = false;
+    double lastFrameMs = 0.0;
+    double peakHoldUntilMs = 0.0;
+    double peakHitUntilMs = 0.0;
+
+    // What is currently on screen, used to work out the dirty region of the next frame
+    float drawnVU = -20.0f;
+    float drawnPeakHoldVU = -20.0f;
+    bool drawnPeakHit = false;
+    int drawnNumChannels = 0;
+    std::array<float, MeterSnapshot::maxChannels> drawnChannelVU {};
+    bool drawnHasReference = false;
+    float drawnReferenceVU = -20.0f;
+    int drawnNumBands = 0;
+    std::array<float, SpectrumAnalyser::maxBands> drawnBandLevels {};
 
     juce::ComboBox displayModeBox;
     std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> displayModeAttachment;
 
+    // Loudness / true-peak readout below the meter; click it to reset loudness, the true-peak
+    // hold and the clip counter
+    juce::ToggleButton truePeakButton{ "True Peak" };
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> truePeakAttachment;
+    juce::ToggleButton loudnessButton{ "LUFS" };
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> loudnessAttachment;
+    juce::Rectangle<int> readoutBounds;
+    std::array<float, TruePeakDetector::maxChannels> truePeakHold {};
+    juce::String readoutText;
+
+   #if VIAU_ENABLE_PROFILING
+    // processBlock cost overlay, toggled from the right-click menu
+    void showProfilerMenu();
+    void updateProfilerOverlay();
+    bool showProfiler = false;
+    juce::String profilerText;
+    juce::Rectangle<int> profilerBounds;
+    std::unique_ptr<juce::FileChooser> profileChooser;
+   #endif
+
+    // Frames come from the process-wide scheduler shared by all open editors
+    juce::SharedResourcePointer<MeterRenderService> renderService;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ViaUAudioProcessorEditor)
 };
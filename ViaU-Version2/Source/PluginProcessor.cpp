@@ -2,13 +2,47 @@
 #include "PluginEditor.h"
 #include <juce_dsp/juce_dsp.h>
 #include <cmath>
+#include <optional>
+
+namespace
+{
+    // Main minus reference level in dB. Both sides are floored at -120 dBFS so a silent bus
+    // gives a large but finite difference.
+    template <typename SampleType>
+    float levelDifferenceDb(SampleType main, SampleType reference) noexcept
+    {
+        constexpr SampleType floor = (SampleType)1.0e-6;
+        return (float)juce::Decibels::gainToDecibels(juce::jmax(main, floor) / juce::jmax(reference, floor));
+    }
+}
 
 ViaUAudioProcessor::ViaUAudioProcessor()
     : AudioProcessor(BusesProperties()
         .withInput("Input", juce::AudioChannelSet::stereo(), true)
+        .withInput("Reference", juce::AudioChannelSet::stereo(), false)
         .withOutput("Output", juce::AudioChannelSet::stereo(), true)),
     apvts(*this, nullptr, "PARAMS", createParameterLayout())
 {
+    displayModeParam = apvts.getRawParameterValue("displayMode");
+    audio.decimatedParam = apvts.getRawParameterValue("decimated");
+    exportParam = apvts.getRawParameterValue("export");
+    recordParam = apvts.getRawParameterValue("record");
+    truePeakParam = apvts.getRawParameterValue("truePeak");
+    loudnessParam = apvts.getRawParameterValue("loudness");
+    spectrumBandsParam = apvts.getRawParameterValue("spectrumBands");
+    spectrumHopParam = apvts.getRawParameterValue("spectrumHop");
+    referenceLevelParam = apvts.getRawParameterValue("referenceLevel");
+    integrationTimeParam = apvts.getRawParameterValue("integrationTime");
+    scaleFloorParam = apvts.getRawParameterValue("scaleFloor");
+    scaleCeilingParam = apvts.getRawParameterValue("scaleCeiling");
+
+    renderService->addHousekeeper(this);
+}
+
+ViaUAudioProcessor::~ViaUAudioProcessor()
+{
+    renderService->removeHousekeeper(this);
+    analysisWorker.release();
 }
 
 #ifndef JucePlugin_PreferredChannelConfigurations
@@ -17,56 +51,399 @@ bool ViaUAudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts) cons
     const auto& in = layouts.getChannelSet(true, 0);
     const auto& out = layouts.getChannelSet(false, 0);
     if (in.isDisabled() || out.isDisabled()) return false;
-    if (in.size() != out.size()) return false;
-    return (in == juce::AudioChannelSet::mono() || in == juce::AudioChannelSet::stereo());
+    if (in != out) return false;
+
+    // The reference bus is optional and may have any layout. It shares the detector with the
+    // main input, which has per-channel state for up to 64 channels between them: mono,
+    // stereo, 5.1, 7.1.4, ambisonics up to 7th order, discrete.
+    const int numReference = layouts.inputBuses.size() > 1 ? layouts.getChannelSet(true, 1).size() : 0;
+    return in.size() + numReference <= viau::maxChannels;
 }
 #endif
 
-void ViaUAudioProcessor::prepareToPlay(double sampleRate, int /*samplesPerBlock*/)
+void ViaUAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
+{
+    analysisWorker.release();
+
+    const double fs = audio.fs = sampleRate;
+    audio.detector.prepare(fs, samplesPerBlock); // rebuilt for fs with the time constant last set
+    audio.doubleDetector.prepare(fs, samplesPerBlock);
+    updateMeterSettings<float>();                       // both precisions, so the first block rebuilds nothing
+    updateMeterSettings<double>();
+    truePeak.prepare(AnalysisWorker::silenceChunk);
+    worker.truePeakWasEnabled = false;
+    loudness.prepare(fs, getChannelLayoutOfBus(true, 0));
+    spectrum.prepare(fs);
+    worker.spectrumWasEnabled = false;
+    correlation.prepare(fs);
+    worker.correlationWasEnabled = false;
+    published.currentVU.store(audio.scale.minVU);
+    published.peakHit.store(false);
+    published.idle.store(false);
+    published.referenceActive.store(false);
+    published.referenceVU.store(audio.scale.minVU);
+
+   #if VIAU_ENABLE_PROFILING
+    profiler.prepare(sampleRate);
+   #endif
+    audio.hasPendingSnapshot = false;
+    audio.samplesProcessed = 0;
+    published.processedPosition.store(0, std::memory_order_relaxed);
+
+    analysisWorker.prepare(fs, samplesPerBlock, getMainBusNumInputChannels());
+}
+
+void ViaUAudioProcessor::releaseResources()
 {
-    fs = sampleRate;
-    const double tau = 0.300; // 300 ms integration
-    alpha = (float)std::exp(-1.0 / (tau * fs));
-    vuIntegrator = 0.0f;
-    currentVU.store(-20.0f);
-    peakHit.store(false);
+    analysisWorker.release();
 }
 
 void ViaUAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midi)
 {
     juce::ignoreUnused(midi);
+    processSamples(buffer);
+}
+
+void ViaUAudioProcessor::processBlock(juce::AudioBuffer<double>& buffer, juce::MidiBuffer& midi)
+{
+    juce::ignoreUnused(midi);
+    processSamples(buffer);
+}
+
+template <typename SampleType>
+void ViaUAudioProcessor::processSamples(juce::AudioBuffer<SampleType>& buffer)
+{
+    VIAU_PROFILE_BLOCK(profiler, buffer.getNumSamples());
+    juce::ScopedNoDenormals noDenormals;
+    updateMeterSettings<SampleType>();
+
+    auto& meter = getDetector<SampleType>();
+    meter.setDecimated(audio.decimatedParam->load() > 0.5f);
     const int numSamples = buffer.getNumSamples();
-    const int numCh = buffer.getNumChannels();
 
-    for (int n = 0; n < numSamples; ++n)
+    // The reference bus's channels follow the main input's in the buffer, so the detector
+    // takes both buses as one channel array: one pass over the block, with each bus read back
+    // as its own channel group.
+    const int numCh = juce::jmin(getMainBusNumInputChannels(), buffer.getNumChannels());
+    const int numRef = juce::jlimit(0, buffer.getNumChannels() - numCh, getChannelCountOfBus(true, 1));
+    const int numMetered = juce::jmin(numCh + numRef, viau::maxChannels);
+
+    // The per-channel peaks (vectorised by getMagnitude) go into the snapshot, and also tell us
+    // whether the whole block is silent.
+    MeterSnapshot snapshot;
+    snapshot.samplePosition = audio.samplesProcessed;
+    snapshot.referenceVU = audio.scale.minVU;
+    snapshot.numChannels = juce::jmin(numCh, MeterSnapshot::maxChannels);
+    for (int ch = 0; ch < snapshot.numChannels; ++ch)
+    {
+        const float magnitude = (float)buffer.getMagnitude(ch, 0, numSamples);
+        snapshot.peak = juce::jmax(snapshot.peak, magnitude);
+        snapshot.channelPeak[(size_t)ch] = magnitude;
+    }
+
+    float referencePeak = 0.0f;
+    for (int ch = numCh; ch < numMetered; ++ch)
+        referencePeak = juce::jmax(referencePeak, (float)buffer.getMagnitude(ch, 0, numSamples));
+
+    // Silence only decays the integrator, until it settles below the scale and goes idle.
+    // Idle since the previous block means the analysers' own history is silent as well, so
+    // they can skip reading the block too.
+    const bool silent = snapshot.peak < viau::silenceThreshold;
+    const bool wasIdle = published.idle.load(std::memory_order_relaxed);
+    const auto reading = viau::meterVUBlock(meter, audio.scale, audio.floorGain, buffer.getArrayOfReadPointers(),
+                                            numMetered, numCh, numSamples, silent && referencePeak < viau::silenceThreshold);
+
+    // The analysers run on the worker, on the main input only. While one of them is on it is
+    // told about every block, and only gets samples when the block is worth reading; while all
+    // are off nothing is queued and the worker is never woken.
+    const bool skipAnalysis = silent && wasIdle;
+    const bool analysing = truePeakParam->load() > 0.5f || loudnessParam->load() > 0.5f
+                        || isSpectrumEnabled() || isCorrelationEnabled();
+
+    if (!analysing)
+        analysisWorker.skip();
+    else if (!skipAnalysis)
+        analysisWorker.push(buffer.getArrayOfReadPointers(), numCh, numSamples);
+    else
+        analysisWorker.pushSilence(numCh, numSamples);
+
+    const auto level = reading.level;
+    const float vu = reading.vu;
+    const bool hit = reading.peakHit;
+    published.currentVU.store(vu);
+    published.peakHit.store(hit);
+
+    if (numRef > 0)
+    {
+        const auto referenceLevel = meter.getGroupLevel(numCh, numMetered - numCh);
+        snapshot.hasReference = true;
+        snapshot.referenceVU = audio.scale.fromLinear(referenceLevel);
+        snapshot.referenceDelta = levelDifferenceDb(level, referenceLevel);
+    }
+
+    published.referenceActive.store(snapshot.hasReference, std::memory_order_relaxed);
+    published.referenceVU.store(snapshot.referenceVU, std::memory_order_relaxed);
+
+    const bool nowIdle = reading.atRest;
+    published.idle.store(nowIdle, std::memory_order_relaxed);
+
+    // The first idle block still goes out, so the editor sees the meter land on the floor
+    const bool isNewReading = !(nowIdle && wasIdle);
+    if (isNewReading)
+    {
+        snapshot.vu = vu;
+        snapshot.peakHit = hit;
+        for (int ch = 0; ch < snapshot.numChannels; ++ch)
+            snapshot.channelVU[(size_t)ch] = audio.scale.fromLinear(meter.getChannelLevel(ch));
+
+        publishSnapshot(snapshot);
+    }
+
+    publishExport(snapshot, isNewReading, nowIdle);
+
+    if (recorder.isRecording())
+        recordBlock(snapshot.peak, vu, hit, numSamples);
+
+    audio.samplesProcessed += numSamples;
+    published.processedPosition.store(audio.samplesProcessed, std::memory_order_relaxed);
+}
+
+VUScale ViaUAudioProcessor::getScale() const noexcept
+{
+    return { referenceLevelParam->load(), scaleFloorParam->load(), scaleCeilingParam->load() };
+}
+
+// Four atomic loads per block. Only the detector for the block's precision is touched, and its
+// weight tables are only refilled when the time constant has moved: no allocation, one
+// multiply per table entry (prepare() sizes them for a new sample rate). The other detector
+// catches up on its first block, if the host ever switches precision.
+template <typename SampleType>
+void ViaUAudioProcessor::updateMeterSettings() noexcept
+{
+    auto& meter = getDetector<SampleType>();
+    const double timeConstant = (double)integrationTimeParam->load() * 0.001;
+    if (timeConstant != meter.getTimeConstant())
+        meter.setTimeConstant(timeConstant);
+
+    const auto newScale = getScale();
+    if (newScale != audio.scale)
+    {
+        audio.scale = newScale;
+        audio.floorGain = audio.scale.getFloorGain();
+    }
+}
+
+void ViaUAudioProcessor::analyse(const float* const* channels, int numChannels, int numSamples, bool silent)
+{
+    if (truePeakParam->load() > 0.5f)
+    {
+        if (!worker.truePeakWasEnabled)
+            truePeak.reset();
+        if (!silent)
+            truePeak.process(channels, numChannels, numSamples);
+        worker.truePeakWasEnabled = true;
+    }
+    else
+    {
+        worker.truePeakWasEnabled = false;
+    }
+
+    if (loudnessParam->load() > 0.5f)
+        if (!(silent && loudness.advanceSilence(numSamples)))
+            loudness.process(channels, numChannels, numSamples);
+
+    if (isSpectrumEnabled())
+    {
+        if (!worker.spectrumWasEnabled)
+            spectrum.reset();
+
+        // "spectrumHop" choices are 1/8, 1/4, 1/2 and 1 frame
+        spectrum.setBandsPerOctave(spectrumBandsParam->load() > 0.5f ? 3 : 1);
+        spectrum.setHopDivisor(8 >> juce::jlimit(0, 3, juce::roundToInt(spectrumHopParam->load())));
+
+        if (silent)
+            spectrum.processSilence(numSamples);
+        else
+            spectrum.process(channels, numChannels, numSamples);
+
+        worker.spectrumWasEnabled = true;
+    }
+    else
+    {
+        worker.spectrumWasEnabled = false;
+    }
+
+    if (isCorrelationEnabled())
+    {
+        if (!worker.correlationWasEnabled)
+            correlation.reset();
+
+        if (silent)
+            correlation.processSilence(numSamples);
+        else
+            correlation.process(channels, numChannels, numSamples);
+
+        worker.correlationWasEnabled = true;
+    }
+    else
+    {
+        worker.correlationWasEnabled = false;
+    }
+}
+
+void ViaUAudioProcessor::analysisResumed()
+{
+    // Blocks were skipped while every analyser was off, so each starts over when switched on
+    worker.truePeakWasEnabled = false;
+    worker.spectrumWasEnabled = false;
+    worker.correlationWasEnabled = false;
+}
+
+void ViaUAudioProcessor::publishExport(const MeterSnapshot& snapshot, bool isNewReading, bool nowIdle) noexcept
+{
+    // Written when there is something new, and once more when export is switched off
+    const bool enabled = exportParam->load() > 0.5f;
+    const bool changed = enabled != audio.exportWasEnabled;
+    audio.exportWasEnabled = enabled;
+
+    if (!(changed || (enabled && isNewReading)))
+        return;
+
+    viau::shm::MeterData data;
+    data.publishTimeNs = viau::shm::nowNs();
+    data.samplePosition = snapshot.samplePosition;
+    data.sampleRate = audio.fs;
+    data.active = enabled;
+    data.idle = nowIdle;
+    data.numChannels = snapshot.numChannels;
+
+    // Idle blocks after the first leave the snapshot's readings unfilled; the meter is at
+    // the floor then anyway
+    if (isNewReading)
+    {
+        data.vu = snapshot.vu;
+        data.peak = snapshot.peak;
+        data.peakHit = snapshot.peakHit;
+        std::copy(snapshot.channelVU.begin(), snapshot.channelVU.begin() + snapshot.numChannels, data.channelVU);
+        std::copy(snapshot.channelPeak.begin(), snapshot.channelPeak.begin() + snapshot.numChannels, data.channelPeak);
+    }
+    else
     {
-        float sampleAbsMean = 0.0f;
-        for (int ch = 0; ch < numCh; ++ch)
-            sampleAbsMean += std::abs(buffer.getReadPointer(ch)[n]);
-        sampleAbsMean /= (float)juce::jmax(1, numCh);
-        vuIntegrator = alpha * vuIntegrator + (1.0f - alpha) * sampleAbsMean;
+        std::fill(data.channelVU, data.channelVU + snapshot.numChannels, audio.scale.minVU);
     }
 
-    constexpr float eps = 1.0e-9f;
-    const float dbfs = juce::Decibels::gainToDecibels(vuIntegrator + eps);
-    float vu = dbfs + 18.0f;
-    vu = juce::jlimit(-20.0f, 3.0f, vu);
-    currentVU.store(vu);
+    if (loudnessParam->load() > 0.5f)
+    {
+        data.momentary = loudness.getMomentary();
+        data.shortTerm = loudness.getShortTerm();
+        data.integrated = loudness.getIntegrated();
+        data.loudnessRange = loudness.getLoudnessRange();
+    }
 
-    peakHit.store(vu >= getPeakThreshold());
+    sharedExport.publish(data);
+}
+
+void ViaUAudioProcessor::recordBlock(float peak, float vu, bool hit, int numSamples) noexcept
+{
+    MeterRecord record;
+    record.processedSample = audio.samplesProcessed;
+    record.vu = vu;
+    record.peak = peak;
+    record.numSamples = (juce::uint32)numSamples;
+    record.flags = hit ? MeterRecord::peakHit : 0;
+
+    if (auto* playHead = getPlayHead())
+    {
+        if (auto position = playHead->getPosition())
+        {
+            if (auto time = position->getTimeInSamples())
+                record.hostSample = *time;
+            if (position->getIsPlaying())
+                record.flags |= MeterRecord::playing;
+        }
+    }
+
+    recorder.push(record);
+}
+
+void ViaUAudioProcessor::housekeep()
+{
+    const bool wantRecording = recordParam->load() > 0.5f;
+    if (!wantRecording)
+        recordStartFailed = false;
+
+    if (wantRecording && !recorder.isRecording() && !recordStartFailed)
+    {
+        juce::String name;
+        {
+            const juce::ScopedLock sl(trackNameLock);
+            name = trackName.isNotEmpty() ? trackName : juce::String(JucePlugin_Name);
+        }
+
+        const auto fileName = juce::File::createLegalFileName(name + " " + juce::Time::getCurrentTime().formatted("%Y-%m-%d %H-%M-%S"));
+        recordStartFailed = !recorder.start(MeterRecorder::getDefaultFolder().getNonexistentChildFile(fileName, ".viaurec", false), audio.fs);
+    }
+    else if (!wantRecording && recorder.isRecording())
+    {
+        recorder.stop();
+    }
+
+    const bool wantExport = exportParam->load() > 0.5f;
+    if (!wantExport)
+        exportRetryTime = 0.0;
+
+    // A failed open() has scanned every slot of the segment; don't repeat that on every tick
+    if (wantExport && !sharedExport.isOpen() && juce::Time::getMillisecondCounterHiRes() >= exportRetryTime)
+    {
+        const juce::ScopedLock sl(trackNameLock);
+        sharedExport.setName(trackName.isNotEmpty() ? trackName : juce::String(JucePlugin_Name));
+
+        if (!sharedExport.open())
+            exportRetryTime = juce::Time::getMillisecondCounterHiRes() + exportRetryIntervalMs;
+    }
+}
+
+namespace
+{
+    // TrackProperties::name is a String in JUCE 7 and an optional<String> in JUCE 8
+    juce::String nameOf(const juce::String& name) { return name; }
+    juce::String nameOf(const std::optional<juce::String>& name) { return name.value_or(juce::String()); }
+}
+
+void ViaUAudioProcessor::updateTrackProperties(const TrackProperties& properties)
+{
+    const juce::ScopedLock sl(trackNameLock);
+    trackName = nameOf(properties.name);
+    sharedExport.setName(trackName.isNotEmpty() ? trackName : juce::String(JucePlugin_Name));
+}
+
+void ViaUAudioProcessor::publishSnapshot(const MeterSnapshot& snapshot) noexcept
+{
+    if (audio.hasPendingSnapshot)
+    {
+        audio.pendingSnapshot.merge(snapshot);
+        audio.hasPendingSnapshot = !snapshotQueue.push(audio.pendingSnapshot);
+    }
+    else if (!snapshotQueue.push(snapshot))
+    {
+        audio.pendingSnapshot = snapshot;
+        audio.hasPendingSnapshot = true;
+    }
 }
 
 juce::AudioProcessorEditor* ViaUAudioProcessor::createEditor() { return new ViaUAudioProcessorEditor(*this); }
 
 void ViaUAudioProcessor::getStateInformation(juce::MemoryBlock& destData)
 {
-    auto state = apvts.copyState();
-    if (auto xml = state.createXml())
-        copyXmlToBinary(*xml, destData);
+    stateCodec.save(destData);
 }
 
 void ViaUAudioProcessor::setStateInformation(const void* data, int sizeInBytes)
 {
+    if (stateCodec.load(data, sizeInBytes))
+        return;
+
+    // Sessions saved before the binary format
     if (auto xml = getXmlFromBinary(data, sizeInBytes))
         if (xml->hasTagName(apvts.state.getType()))
             apvts.replaceState(juce::ValueTree::fromXml(*xml));
@@ -76,7 +453,29 @@ juce::AudioProcessorValueTreeState::ParameterLayout ViaUAudioProcessor::createPa
 {
     std::vector<std::unique_ptr<juce::RangedAudioParameter>> params;
     params.push_back(std::make_unique<juce::AudioParameterChoice>(
-        "displayMode", "Display Mode", juce::StringArray{ "LED", "Needle" }, 0));
+        "displayMode", "Display Mode", juce::StringArray{ "LED", "Needle", "History", "Spectrum", "Goniometer" }, 0));
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+        "decimated", "Decimated Detection", false));
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+        "truePeak", "True Peak", false));
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+        "loudness", "Loudness", false));
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+        "export", "Dashboard Export", false));
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+        "record", "Record Meter", false));
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        "spectrumBands", "Spectrum Bands", juce::StringArray{ "Octave", "Third Octave" }, 1));
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        "spectrumHop", "Spectrum Hop", juce::StringArray{ "1/8 Frame", "1/4 Frame", "1/2 Frame", "Full Frame" }, 1));
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "referenceLevel", "Reference Level", juce::NormalisableRange<float>(-24.0f, -8.0f, 0.5f), -18.0f));
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "integrationTime", "Integration Time", juce::NormalisableRange<float>(50.0f, 1000.0f, 1.0f, 0.5f), 300.0f));
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "scaleFloor", "Scale Floor", juce::NormalisableRange<float>(-40.0f, -10.0f, 1.0f), -20.0f));
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "scaleCeiling", "Scale Ceiling", juce::NormalisableRange<float>(0.0f, 6.0f, 1.0f), 3.0f));
     return { params.begin(), params.end() };
 }
 
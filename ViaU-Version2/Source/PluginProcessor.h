@@ -1,22 +1,41 @@
 #pragma once
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <atomic>
+#include "../../ViaU-Common/MeteringCore.h"
+#include "MeterSnapshotQueue.h"
+#include "TruePeakDetector.h"
+#include "LoudnessMeter.h"
+#include "ProcessProfiler.h"
+#include "SharedMeterExport.h"
+#include "MeterRecorder.h"
+#include "AnalysisWorker.h"
+#include "SpectrumAnalyser.h"
+#include "CorrelationMeter.h"
+#include "VUScale.h"
+#include "VUBlockMeter.h"
+#include "PluginState.h"
+#include "MeterRenderService.h"
 
-class ViaUAudioProcessor : public juce::AudioProcessor
+class ViaUAudioProcessor : public juce::AudioProcessor,
+    private MeterRenderService::Housekeeper,
+    private AnalysisWorker::Client
 {
 public:
     ViaUAudioProcessor();
-    ~ViaUAudioProcessor() override = default;
+    ~ViaUAudioProcessor() override;
 
     //==============================================================================
     void prepareToPlay(double sampleRate, int samplesPerBlock) override;
-    void releaseResources() override {}
+    void releaseResources() override;
 
 #ifndef JucePlugin_PreferredChannelConfigurations
     bool isBusesLayoutSupported(const BusesLayout& layouts) const override;
 #endif
 
+    // Both precisions are metered natively; hosts with a 64-bit mix engine skip the conversion
+    bool supportsDoublePrecisionProcessing() const override { return true; }
     void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlock(juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
 
     //==============================================================================
     juce::AudioProcessorEditor* createEditor() override;
@@ -36,27 +55,186 @@ public:
     const juce::String getProgramName(int) override { return {}; }
     void changeProgramName(int, const juce::String&) override {}
 
+    //==============================================================================
+    void updateTrackProperties(const TrackProperties& properties) override;
+
     //==============================================================================
     void getStateInformation(juce::MemoryBlock& destData) override;
     void setStateInformation(const void* data, int sizeInBytes) override;
 
     // Expose current VU level (in VU units)
-    float getCurrentVU() const noexcept { return currentVU.load(); }
+    float getCurrentVU() const noexcept { return published.currentVU.load(); }
+
+    // The scale readings are on, from the "referenceLevel", "scaleFloor" and "scaleCeiling"
+    // parameters. Any thread; the audio thread keeps its own copy, see updateMeterSettings().
+    VUScale getScale() const noexcept;
 
     // Peak detection
-    bool isPeakHit() const noexcept { return peakHit.load(); }
-    float getPeakThreshold() const noexcept { return 0.0f; }
+    bool isPeakHit() const noexcept { return published.peakHit.load(); }
+    float getPeakThreshold() const noexcept { return VUScale::peakVU; }
+
+    // Reference (sidechain) bus, metered with the same ballistics as the main input. Its
+    // reading and the level difference go out with every snapshot.
+    bool hasReference() const noexcept { return published.referenceActive.load(std::memory_order_relaxed); }
+    float getReferenceVU() const noexcept { return published.referenceVU.load(std::memory_order_relaxed); }
+
+    // True while the input is digitally silent and the meter has settled at the bottom of the
+    // scale. Blocks are then only counted, and no snapshots are published.
+    bool isIdle() const noexcept { return published.idle.load(std::memory_order_relaxed); }
+
+    // Samples processed since prepareToPlay; keeps advancing while idle, when no snapshots go out
+    juce::int64 getSamplesProcessed() const noexcept { return published.processedPosition.load(std::memory_order_relaxed); }
+
+    // True-peak (4x oversampled) detection, enabled by the "truePeak" parameter
+    bool isTruePeakEnabled() const noexcept { return truePeakParam->load() > 0.5f; }
+    TruePeakDetector& getTruePeakDetector() noexcept { return truePeak; }
+
+    // EBU R128 loudness, enabled by the "loudness" parameter
+    bool isLoudnessEnabled() const noexcept { return loudnessParam->load() > 0.5f; }
+    LoudnessMeter& getLoudnessMeter() noexcept { return loudness; }
+
+    // Band spectrum, analysed while the editor's display mode is "Spectrum"
+    bool isSpectrumEnabled() const noexcept { return juce::roundToInt(displayModeParam->load()) == spectrumDisplayMode; }
+    SpectrumAnalyser& getSpectrumAnalyser() noexcept { return spectrum; }
+    static constexpr int spectrumDisplayMode = 3;       // index in the "displayMode" choices
+
+    // Phase correlation and goniometer points, analysed while the display mode is "Goniometer"
+    bool isCorrelationEnabled() const noexcept { return juce::roundToInt(displayModeParam->load()) == goniometerDisplayMode; }
+    CorrelationMeter& getCorrelationMeter() noexcept { return correlation; }
+    static constexpr int goniometerDisplayMode = 4;
+
+    // Blocks the analysis worker had no room for since prepareToPlay
+    juce::int64 getNumDroppedAnalysisBlocks() const noexcept { return analysisWorker.getNumDroppedBlocks(); }
+
+   #if VIAU_ENABLE_PROFILING
+    // Cost of every processBlock call (build with VIAU_ENABLE_PROFILING=1)
+    ProcessProfiler& getProfiler() noexcept { return profiler; }
+   #endif
+
+    // Drains per-block snapshots published by the audio thread (message thread only).
+    int popSnapshots(MeterSnapshot* dest, int maxNum) noexcept { return snapshotQueue.pop(dest, maxNum); }
 
     // Parameter layout / state
     static juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
     juce::AudioProcessorValueTreeState apvts;
 
 private:
-    double fs = 44100.0;
-    float vuIntegrator = 0.0f;
-    float alpha = 0.0f;
-    std::atomic<float> currentVU{ -20.0f };
-    std::atomic<bool> peakHit{ false };
+    // Binary session state (see PluginState.h); sessions saved as XML by earlier builds still load
+    PluginStateCodec stateCodec{ apvts };
+
+    // State is grouped by the thread that writes it, each group on its own cache line(s), so
+    // the audio thread's per-block writes never invalidate a line another thread is reading.
+    //
+    // Written by the audio thread, read by the editor, housekeeping and the host
+    struct alignas(64) PublishedState
+    {
+        std::atomic<float> currentVU{ -20.0f };
+        std::atomic<float> referenceVU{ -20.0f };
+        std::atomic<bool> peakHit{ false };
+        std::atomic<bool> idle{ false };
+        std::atomic<bool> referenceActive{ false };
+        std::atomic<juce::int64> processedPosition{ 0 };
+    };
+
+    // Touched by the audio thread only, and by prepareToPlay while it is stopped. Housekeeping
+    // also reads fs, which only changes then.
+    struct alignas(64) AudioThreadState
+    {
+        double fs = 44100.0;
+        viau::Meter<viau::AbsDetector, viau::VUBallistics> detector; // rectifier + one-pole integrator, 300 ms by default
+        viau::Meter<viau::AbsDetector, viau::VUBallistics, viau::dynamicChannelCount, double> doubleDetector;
+        std::atomic<float>* decimatedParam = nullptr;   // see viau::Meter::setDecimated()
+        VUScale scale;
+        double floorGain = scale.getFloorGain();        // below it an idle integrator snaps to zero
+        juce::int64 samplesProcessed = 0;
+        bool hasPendingSnapshot = false;
+        bool exportWasEnabled = false;
+        MeterSnapshot pendingSnapshot;                  // see publishSnapshot()
+    };
+
+    // Touched by the analysis worker only
+    struct alignas(64) WorkerState
+    {
+        bool truePeakWasEnabled = false;
+        bool spectrumWasEnabled = false;
+        bool correlationWasEnabled = false;
+    };
+
+    PublishedState published;
+    AudioThreadState audio;
+    WorkerState worker;
+
+    // Calibration and ballistics, applied at the start of each block when they have changed
+    template <typename SampleType>
+    void updateMeterSettings() noexcept;
+    std::atomic<float>* referenceLevelParam = nullptr;
+    std::atomic<float>* integrationTimeParam = nullptr;  // ms
+    std::atomic<float>* scaleFloorParam = nullptr;
+    std::atomic<float>* scaleCeilingParam = nullptr;
+
+    TruePeakDetector truePeak;
+    std::atomic<float>* truePeakParam = nullptr;
+
+    LoudnessMeter loudness;
+    std::atomic<float>* loudnessParam = nullptr;
+
+    SpectrumAnalyser spectrum;
+    std::atomic<float>* displayModeParam = nullptr;
+    std::atomic<float>* spectrumBandsParam = nullptr;
+    std::atomic<float>* spectrumHopParam = nullptr;
+
+    CorrelationMeter correlation;
+
+    // True peak, loudness, the spectrum and the correlation meter run on this worker; the audio thread only queues the block.
+    // Declared after the analysers, which it calls into until it is released.
+    void analyse(const float* const* channels, int numChannels, int numSamples, bool silent) override;
+    void analysisResumed() override;
+    AnalysisWorker analysisWorker{ *this };
+
+    template <typename SampleType>
+    void processSamples(juce::AudioBuffer<SampleType>& buffer);
+
+    template <typename SampleType>
+    auto& getDetector() noexcept
+    {
+        if constexpr (std::is_same<SampleType, double>::value)
+            return audio.doubleDetector;
+        else
+            return audio.detector;
+    }
+
+   #if VIAU_ENABLE_PROFILING
+    ProcessProfiler profiler;
+   #endif
+
+    // Recorder and export housekeeping, on the message thread from the process-wide
+    // MeterRenderService timer rather than a timer of our own.
+    void housekeep() override;
+    juce::SharedResourcePointer<MeterRenderService> renderService;
+
+    // Shared-memory export for external dashboards, enabled by the "export" parameter.
+    // housekeep() claims the slot and keeps its name current. When no slot can be claimed it
+    // tries again every exportRetryIntervalMs, or as soon as the parameter is switched off and on.
+    void publishExport(const MeterSnapshot& snapshot, bool isNewReading, bool nowIdle) noexcept;
+    SharedMeterExport sharedExport;
+    std::atomic<float>* exportParam = nullptr;
+    static constexpr double exportRetryIntervalMs = 5000.0;
+    double exportRetryTime = 0.0;                       // message thread, getMillisecondCounterHiRes()
+    juce::String trackName;
+    juce::CriticalSection trackNameLock;
+
+    // Per-block VU/peak with the host timeline position, spooled to disk while the "record"
+    // parameter is on. housekeep() starts and stops the recorder; a start that fails (no
+    // folder, full disk) is not retried until the parameter has been switched off and on.
+    void recordBlock(float peak, float vu, bool hit, int numSamples) noexcept;
+    MeterRecorder recorder;
+    std::atomic<float>* recordParam = nullptr;
+    bool recordStartFailed = false;                     // message thread
+
+    // Per-block snapshots for the editor. If the queue is full the block is folded into
+    // audio.pendingSnapshot and retried, so peaks survive a stalled message thread.
+    void publishSnapshot(const MeterSnapshot& snapshot) noexcept;
+    MeterSnapshotQueue<512> snapshotQueue;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ViaUAudioProcessor)
 };
@@ -0,0 +1,149 @@
+#include "PluginState.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+    constexpr size_t headerBytes = sizeof(PluginStateHeader);
+    constexpr size_t recordBytes = sizeof(PluginStateRecord);
+
+    void writeUInt32(char* dest, juce::uint32 value) noexcept
+    {
+        value = juce::ByteOrder::swapIfBigEndian(value);
+        std::memcpy(dest, &value, sizeof(value));
+    }
+
+    void writeUInt16(char* dest, juce::uint16 value) noexcept
+    {
+        value = juce::ByteOrder::swapIfBigEndian(value);
+        std::memcpy(dest, &value, sizeof(value));
+    }
+
+    void writeFloat(char* dest, float value) noexcept
+    {
+        juce::uint32 bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        writeUInt32(dest, bits);
+    }
+
+    float readFloat(const char* src) noexcept
+    {
+        const juce::uint32 bits = juce::ByteOrder::littleEndianInt(src);
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    // Header fields at their byte offsets; valid only after isPluginState()
+    PluginStateHeader readHeader(const char* src) noexcept
+    {
+        PluginStateHeader header;
+        header.magic = juce::ByteOrder::littleEndianInt(src);
+        header.version = juce::ByteOrder::littleEndianShort(src + 4);
+        header.headerSize = juce::ByteOrder::littleEndianShort(src + 6);
+        header.recordSize = juce::ByteOrder::littleEndianShort(src + 8);
+        header.reserved = juce::ByteOrder::littleEndianShort(src + 10);
+        header.numRecords = juce::ByteOrder::littleEndianInt(src + 12);
+        return header;
+    }
+}
+
+PluginStateCodec::PluginStateCodec(juce::AudioProcessorValueTreeState& apvts)
+{
+    for (auto* p : apvts.processor.getParameters())
+        if (auto* parameter = dynamic_cast<juce::RangedAudioParameter*>(p))
+            entries.push_back({ hashParameterID(parameter->getParameterID()), parameter });
+
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.idHash < b.idHash; });
+
+    // Two IDs with the same hash could not be told apart in a saved state
+    jassert(std::adjacent_find(entries.begin(), entries.end(),
+                               [](const Entry& a, const Entry& b) { return a.idHash == b.idHash; }) == entries.end());
+}
+
+juce::uint32 PluginStateCodec::hashParameterID(const juce::String& parameterID) noexcept
+{
+    juce::uint32 hash = 2166136261u;
+    for (auto p = parameterID.toRawUTF8(); *p != 0; ++p)
+        hash = (hash ^ (juce::uint8)*p) * 16777619u;
+    return hash;
+}
+
+bool PluginStateCodec::isPluginState(const void* data, int sizeInBytes) noexcept
+{
+    if (data == nullptr || sizeInBytes < (int)headerBytes)
+        return false;
+
+    const auto header = readHeader(static_cast<const char*>(data));
+    return header.magic == PluginStateHeader::expectedMagic
+        && header.headerSize >= headerBytes
+        && header.recordSize >= recordBytes
+        && (juce::uint64)header.headerSize + (juce::uint64)header.recordSize * header.numRecords <= (juce::uint64)sizeInBytes;
+}
+
+void PluginStateCodec::save(juce::MemoryBlock& dest) const
+{
+    dest.setSize(headerBytes + recordBytes * entries.size(), false);
+    auto* out = static_cast<char*>(dest.getData());
+
+    const PluginStateHeader header;
+    writeUInt32(out, header.magic);
+    writeUInt16(out + 4, header.version);
+    writeUInt16(out + 6, header.headerSize);
+    writeUInt16(out + 8, header.recordSize);
+    writeUInt16(out + 10, header.reserved);
+    writeUInt32(out + 12, (juce::uint32)entries.size());
+    out += headerBytes;
+
+    for (auto& entry : entries)
+    {
+        writeUInt32(out, entry.idHash);
+        writeFloat(out + 4, entry.parameter->convertFrom0to1(entry.parameter->getValue()));
+        out += recordBytes;
+    }
+}
+
+bool PluginStateCodec::load(const void* data, int sizeInBytes) const
+{
+    if (!isPluginState(data, sizeInBytes))
+        return false;
+
+    const auto* in = static_cast<const char*>(data);
+    const auto header = readHeader(in);
+    const char* record = in + header.headerSize;
+    const char* const end = record + (size_t)header.recordSize * header.numRecords;
+
+    // Out of order, the merge below would miss records and reset their parameters
+    for (auto* next = record + header.recordSize; next < end; next += header.recordSize)
+        if (juce::ByteOrder::littleEndianInt(next - header.recordSize) >= juce::ByteOrder::littleEndianInt(next))
+            return false;
+
+    auto apply = [](juce::RangedAudioParameter& parameter, float normalised)
+        {
+            // Hosts hear about a parameter only if the state actually moves it
+            if (parameter.getValue() != normalised)
+                parameter.setValueNotifyingHost(normalised);
+        };
+
+    // Both sides are sorted by hash: step whichever is behind
+    for (auto& entry : entries)
+    {
+        while (record < end && juce::ByteOrder::littleEndianInt(record) < entry.idHash)
+            record += header.recordSize;
+
+        if (record < end && juce::ByteOrder::littleEndianInt(record) == entry.idHash)
+        {
+            const float value = readFloat(record + 4);
+            apply(*entry.parameter, std::isfinite(value) ? entry.parameter->convertTo0to1(value)
+                                                         : entry.parameter->getDefaultValue());
+            record += header.recordSize;
+        }
+        else
+        {
+            apply(*entry.parameter, entry.parameter->getDefaultValue());
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <vector>
+
+// Binary encoding of the plugin state (the APVTS parameters), as saved in host sessions.
+//
+//   PluginStateHeader                        16 bytes
+//   PluginStateRecord[numRecords]            recordSize bytes each (8 in version 1)
+//
+// Little-endian throughout, so sessions move between machines. A record is a parameter,
+// identified by the 32-bit FNV-1a hash of its ID, and its plain (not normalised) value, so
+// a saved value keeps its meaning if a parameter's range changes. Records are in strictly
+// ascending hash order, as is the codec's parameter table, so decoding is a single merge
+// pass over the fixed-size records: no XML, no string parsing and no allocation. A chunk
+// whose records are out of order is rejected.
+//
+// Compatibility: records with an unknown hash are skipped, parameters without a record are
+// reset to their default, and a later version may append fields to the header or the record,
+// which this reader steps over by recordSize. Chunks that are not in this format (sessions
+// saved by earlier builds, as XML) are left to the caller.
+struct PluginStateHeader
+{
+    static constexpr juce::uint32 expectedMagic = 0x54535556;      // "VUST"
+    static constexpr juce::uint16 currentVersion = 1;
+
+    juce::uint32 magic = expectedMagic;
+    juce::uint16 version = currentVersion;
+    juce::uint16 headerSize = 16;
+    juce::uint16 recordSize = 8;
+    juce::uint16 reserved = 0;
+    juce::uint32 numRecords = 0;
+};
+
+struct PluginStateRecord
+{
+    juce::uint32 idHash = 0;
+    float value = 0.0f;
+};
+
+static_assert(sizeof(PluginStateHeader) == 16, "PluginStateHeader is part of the state format");
+static_assert(sizeof(PluginStateRecord) == 8, "PluginStateRecord is part of the state format");
+
+//==============================================================================
+class PluginStateCodec
+{
+public:
+    // Collects the parameters and hashes their IDs once; the state is coded against this table
+    explicit PluginStateCodec(juce::AudioProcessorValueTreeState& apvts);
+
+    // Replaces dest's contents with the current parameter values
+    void save(juce::MemoryBlock& dest) const;
+
+    // Applies a chunk written by save(). Returns false, changing nothing, if the data is not
+    // in this format or its records are not in ascending hash order.
+    bool load(const void* data, int sizeInBytes) const;
+
+    static bool isPluginState(const void* data, int sizeInBytes) noexcept;
+    static juce::uint32 hashParameterID(const juce::String& parameterID) noexcept;
+
+private:
+    struct Entry
+    {
+        juce::uint32 idHash = 0;
+        juce::RangedAudioParameter* parameter = nullptr;
+    };
+
+    std::vector<Entry> entries;                         // sorted by idHash
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PluginStateCodec)
+};
@@ -0,0 +1,129 @@
+#include "ProcessProfiler.h"
+
+#if VIAU_ENABLE_PROFILING
+#include <cmath>
+
+ProcessProfiler::ProcessProfiler()
+    : nsPerTick(1.0e9 / (double)juce::Time::getHighResolutionTicksPerSecond())
+{
+}
+
+int ProcessProfiler::bucketFor(juce::uint64 ns) noexcept
+{
+    if (ns < ((juce::uint64)1 << minLog2Ns))
+        return 0;
+
+    // ns = m * 2^e with m in [0.5, 1): the exponent gives the octave, the mantissa the quarter
+    int e = 0;
+    const double m = std::frexp((double)ns, &e);
+    const int octave = e - 1;
+    const int quarter = juce::jmin(bucketsPerOctave - 1, (int)((m * 2.0 - 1.0) * bucketsPerOctave));
+    return juce::jmin(numBuckets - 1, (octave - minLog2Ns) * bucketsPerOctave + quarter);
+}
+
+double ProcessProfiler::getBucketLowerNs(int bucket) noexcept
+{
+    const int octave = minLog2Ns + bucket / bucketsPerOctave;
+    const int quarter = bucket % bucketsPerOctave;
+    return std::ldexp(1.0 + quarter / (double)bucketsPerOctave, octave);
+}
+
+void ProcessProfiler::record(juce::int64 ticks, int numSamples) noexcept
+{
+    if (resetRequested.load(std::memory_order_relaxed) && resetRequested.exchange(false))
+    {
+        for (auto& c : counts)
+            c.store(0, std::memory_order_relaxed);
+
+        numBlocks.store(0, std::memory_order_relaxed);
+        totalNs.store(0, std::memory_order_relaxed);
+        totalBudgetNs.store(0, std::memory_order_relaxed);
+        worstNs.store(0, std::memory_order_relaxed);
+        worstBudgetRatio.store(0.0f, std::memory_order_relaxed);
+    }
+
+    const auto ns = (juce::uint64)juce::jmax((juce::int64)0, (juce::int64)((double)ticks * nsPerTick));
+    const auto budgetNs = (juce::uint64)((double)numSamples * secondsPerSample * 1.0e9);
+
+    bump(counts[(size_t)bucketFor(ns)], (juce::uint32)1);
+    bump(numBlocks, (juce::uint64)1);
+    bump(totalNs, ns);
+    bump(totalBudgetNs, budgetNs);
+
+    if (ns > worstNs.load(std::memory_order_relaxed))
+        worstNs.store(ns, std::memory_order_relaxed);
+
+    if (budgetNs > 0)
+    {
+        const float ratio = (float)((double)ns / (double)budgetNs);
+        if (ratio > worstBudgetRatio.load(std::memory_order_relaxed))
+            worstBudgetRatio.store(ratio, std::memory_order_relaxed);
+    }
+}
+
+ProcessProfiler::Stats ProcessProfiler::getStats() const noexcept
+{
+    // Fields are read one by one while the audio thread keeps writing, so they can be a block
+    // apart from each other; fine for a diagnostic readout.
+    Stats stats;
+
+    for (size_t b = 0; b < counts.size(); ++b)
+        stats.counts[b] = counts[b].load(std::memory_order_relaxed);
+
+    stats.numBlocks = numBlocks.load(std::memory_order_relaxed);
+    const auto total = (double)totalNs.load(std::memory_order_relaxed);
+    const auto budget = (double)totalBudgetNs.load(std::memory_order_relaxed);
+
+    stats.meanNs = stats.numBlocks > 0 ? total / (double)stats.numBlocks : 0.0;
+    stats.worstNs = (double)worstNs.load(std::memory_order_relaxed);
+    stats.meanBudgetRatio = budget > 0.0 ? total / budget : 0.0;
+    stats.worstBudgetRatio = (double)worstBudgetRatio.load(std::memory_order_relaxed);
+    return stats;
+}
+
+double ProcessProfiler::Stats::getPercentileNs(double percentile) const noexcept
+{
+    juce::uint64 total = 0;
+    for (auto c : counts)
+        total += c;
+
+    if (total == 0)
+        return 0.0;
+
+    // Upper edge of the bucket holding the percentile, so the figure is never optimistic
+    const double target = percentile / 100.0 * (double)total;
+    juce::uint64 cumulative = 0;
+
+    for (int b = 0; b < numBuckets; ++b)
+    {
+        cumulative += counts[(size_t)b];
+        if ((double)cumulative >= target)
+            return getBucketLowerNs(b + 1);
+    }
+
+    return getBucketLowerNs(numBuckets);
+}
+
+bool ProcessProfiler::writeToFile(const juce::File& file) const
+{
+    const auto stats = getStats();
+    juce::String text;
+
+    text << "# ViaU processBlock profile, " << juce::Time::getCurrentTime().toISO8601(true) << "\n"
+         << "blocks " << (juce::int64)stats.numBlocks << "\n"
+         << "mean_ns " << juce::String(stats.meanNs, 0) << "\n"
+         << "p50_ns " << juce::String(stats.getPercentileNs(50.0), 0) << "\n"
+         << "p99_ns " << juce::String(stats.getPercentileNs(99.0), 0) << "\n"
+         << "worst_ns " << juce::String(stats.worstNs, 0) << "\n"
+         << "mean_budget_ratio " << juce::String(stats.meanBudgetRatio, 6) << "\n"
+         << "worst_budget_ratio " << juce::String(stats.worstBudgetRatio, 6) << "\n"
+         << "# bucket_lower_ns bucket_upper_ns count\n";
+
+    for (int b = 0; b < numBuckets; ++b)
+        text << juce::String(getBucketLowerNs(b), 0) << " " << juce::String(getBucketLowerNs(b + 1), 0)
+             << " " << (juce::int64)stats.counts[(size_t)b] << "\n";
+
+    return file.replaceWithText(text);
+}
+
+#endif
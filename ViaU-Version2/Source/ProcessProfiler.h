@@ -0,0 +1,98 @@
+#pragma once
+#include <juce_core/juce_core.h>
+#include <array>
+#include <atomic>
+
+// Build flag for the processBlock profiler. Off by default; define VIAU_ENABLE_PROFILING=1 in
+// the project's preprocessor definitions to build it in. With it off, the class, the
+// processor member and the editor overlay do not exist and VIAU_PROFILE_BLOCK expands to
+// nothing.
+#ifndef VIAU_ENABLE_PROFILING
+ #define VIAU_ENABLE_PROFILING 0
+#endif
+
+#if VIAU_ENABLE_PROFILING
+
+// Audio-thread cost of processBlock.
+//
+// Each call is timed with the high-resolution tick counter and counted in a fixed histogram
+// with four linear buckets per octave (64 ns .. ~1 s). The profiler also keeps the worst case
+// and the budget ratio, i.e. time spent over the duration of the buffer. The audio thread is
+// the only writer, so every update is a relaxed load and store with no read-modify-write, no
+// locks and no allocation: two tick reads and a few dozen instructions per block.
+//
+// Any thread may read with getStats(). Resets are requested and applied by the audio thread,
+// like LoudnessMeter::requestReset().
+class ProcessProfiler
+{
+public:
+    // Small blocks on the block kernel finish well under a microsecond, so the range starts
+    // low enough to tell them apart
+    static constexpr int minLog2Ns = 6;                 // bucket 0 starts at 64 ns and also counts anything faster
+    static constexpr int bucketsPerOctave = 4;
+    static constexpr int numBuckets = 24 * bucketsPerOctave;    // up to 2^30 ns
+
+    struct Stats
+    {
+        std::array<juce::uint32, numBuckets> counts {};
+        juce::uint64 numBlocks = 0;
+        double meanNs = 0.0;
+        double worstNs = 0.0;
+        double meanBudgetRatio = 0.0;                   // total time / total buffer duration
+        double worstBudgetRatio = 0.0;
+
+        double getPercentileNs(double percentile) const noexcept;
+    };
+
+    ProcessProfiler();
+
+    void prepare(double sampleRate) noexcept { secondsPerSample = 1.0 / sampleRate; }
+
+    // Audio thread. One RAII scope per processBlock call, see VIAU_PROFILE_BLOCK.
+    struct ScopedBlock
+    {
+        ScopedBlock(ProcessProfiler& p, int n) noexcept : profiler(p), numSamples(n), start(juce::Time::getHighResolutionTicks()) {}
+        ~ScopedBlock() { profiler.record(juce::Time::getHighResolutionTicks() - start, numSamples); }
+
+        ProcessProfiler& profiler;
+        const int numSamples;
+        const juce::int64 start;
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedBlock)
+    };
+
+    // Any thread
+    Stats getStats() const noexcept;
+    void requestReset() noexcept { resetRequested.store(true); }
+
+    // Bucket b covers [getBucketLowerNs(b), getBucketLowerNs(b + 1))
+    static double getBucketLowerNs(int bucket) noexcept;
+
+    // Message thread: human-readable dump of getStats(), one bucket per line
+    bool writeToFile(const juce::File& file) const;
+
+private:
+    void record(juce::int64 ticks, int numSamples) noexcept;
+    static int bucketFor(juce::uint64 ns) noexcept;
+
+    template <typename T>
+    static void bump(std::atomic<T>& a, T amount) noexcept { a.store(a.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed); }
+
+    const double nsPerTick;
+    double secondsPerSample = 1.0 / 44100.0;
+
+    std::array<std::atomic<juce::uint32>, numBuckets> counts {};
+    std::atomic<juce::uint64> numBlocks{ 0 };
+    std::atomic<juce::uint64> totalNs{ 0 };
+    std::atomic<juce::uint64> totalBudgetNs{ 0 };
+    std::atomic<juce::uint64> worstNs{ 0 };
+    std::atomic<float> worstBudgetRatio{ 0.0f };
+    std::atomic<bool> resetRequested{ false };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ProcessProfiler)
+};
+
+ #define VIAU_PROFILE_BLOCK(profiler, numSamples) const ProcessProfiler::ScopedBlock viauProfileScope (profiler, numSamples)
+#else
+ #define VIAU_PROFILE_BLOCK(profiler, numSamples)
+#endif
@@ -0,0 +1,119 @@
+#include "SharedMeterExport.h"
+
+#if JUCE_MAC || JUCE_LINUX || JUCE_BSD
+ #include <cerrno>
+ #include <fcntl.h>
+ #include <signal.h>
+ #include <sys/mman.h>
+ #include <sys/stat.h>
+ #include <unistd.h>
+ #define VIAU_SHARED_MEMORY 1
+#else
+ #define VIAU_SHARED_MEMORY 0
+#endif
+
+#if VIAU_SHARED_MEMORY
+namespace
+{
+    std::atomic<std::uint32_t> nextInstanceNumber{ 1 };
+
+    // Slots of processes that died without releasing them can be taken over
+    bool isOwnerAlive(std::uint64_t owner)
+    {
+        const auto pid = (pid_t)viau::shm::ownerPid(owner);
+        return pid > 0 && (::kill(pid, 0) == 0 || errno == EPERM);
+    }
+
+    viau::shm::Segment* mapSegment()
+    {
+        const int fd = ::shm_open(viau::shm::segmentName, O_RDWR | O_CREAT, 0666);
+        if (fd < 0)
+            return nullptr;
+
+        // A new segment has size 0; ftruncate zero-fills it, which marks every slot free
+        struct stat info {};
+        const bool sized = ::fstat(fd, &info) == 0
+                        && ((size_t)info.st_size >= sizeof(viau::shm::Segment)
+                            || ::ftruncate(fd, (off_t)sizeof(viau::shm::Segment)) == 0);
+
+        void* address = sized ? ::mmap(nullptr, sizeof(viau::shm::Segment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)
+                              : MAP_FAILED;
+        ::close(fd);
+
+        if (address == MAP_FAILED)
+            return nullptr;
+
+        auto* segment = static_cast<viau::shm::Segment*>(address);
+        if (segment->header.magic.load(std::memory_order_acquire) == 0)
+            viau::shm::initialise(*segment);
+
+        if (!viau::shm::isCompatible(*segment))
+        {
+            // Written by a different ViaU version; leave it alone
+            ::munmap(address, sizeof(viau::shm::Segment));
+            return nullptr;
+        }
+
+        return segment;
+    }
+}
+#endif
+
+SharedMeterExport::~SharedMeterExport()
+{
+   #if VIAU_SHARED_MEMORY
+    if (auto* s = slot.load())
+    {
+        viau::shm::MeterData inactive;
+        inactive.publishTimeNs = viau::shm::nowNs();
+        viau::shm::writeSlot(*s, inactive);
+        s->owner.store(0, std::memory_order_release);
+    }
+
+    if (segment != nullptr)
+        ::munmap(segment, sizeof(viau::shm::Segment));
+   #endif
+}
+
+bool SharedMeterExport::open()
+{
+   #if VIAU_SHARED_MEMORY
+    if (isOpen())
+        return true;
+
+    if (segment == nullptr && (segment = mapSegment()) == nullptr)
+        return false;
+
+    const auto token = ((std::uint64_t)(std::uint32_t)::getpid() << 32) | nextInstanceNumber.fetch_add(1);
+
+    for (auto& candidate : segment->slots)
+    {
+        auto current = candidate.owner.load(std::memory_order_acquire);
+
+        if ((current == 0 || !isOwnerAlive(current))
+            && candidate.owner.compare_exchange_strong(current, token, std::memory_order_acq_rel))
+        {
+            // Start from a clean, inactive reading; this also faults the pages in
+            viau::shm::resetSequences(candidate);
+            viau::shm::MeterData inactive;
+            inactive.publishTimeNs = viau::shm::nowNs();
+            viau::shm::writeSlot(candidate, inactive);
+            viau::shm::writeName(candidate, name.toRawUTF8());
+
+            slot.store(&candidate, std::memory_order_release);
+            return true;
+        }
+    }
+   #endif
+
+    return false;
+}
+
+void SharedMeterExport::setName(const juce::String& newName)
+{
+    // Names are truncated to what fits the slot, including a terminator
+    name = newName;
+
+    if (auto* s = slot.load())
+        viau::shm::writeName(*s, name.toRawUTF8());
+}
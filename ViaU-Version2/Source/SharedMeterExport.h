@@ -0,0 +1,40 @@
+#pragma once
+#include <juce_core/juce_core.h>
+#include <atomic>
+#include "SharedMeterLayout.h"
+
+// Publishes one plugin instance's meters into the shared-memory segment described in
+// SharedMeterLayout.h, for external dashboards.
+//
+// POSIX only (macOS, Linux); elsewhere open() fails and publish() does nothing.
+//
+// open() and setName() run on the message thread: they map the segment and claim a slot,
+// which also faults the slot's pages in. publish() runs on the audio thread and is a wait-free
+// seqlock write into memory that is already mapped. Once claimed, the slot and the mapping are
+// kept until destruction, so the audio thread never writes to memory that has gone away. An
+// instance that stops exporting publishes with MeterData::active cleared instead.
+class SharedMeterExport
+{
+public:
+    SharedMeterExport() = default;
+    ~SharedMeterExport();
+
+    // Message thread. Returns true once a slot is held (immediately, if one already is).
+    bool open();
+    bool isOpen() const noexcept { return slot.load(std::memory_order_acquire) != nullptr; }
+    void setName(const juce::String& newName);
+
+    // Audio thread
+    void publish(const viau::shm::MeterData& data) noexcept
+    {
+        if (auto* s = slot.load(std::memory_order_acquire))
+            viau::shm::writeSlot(*s, data);
+    }
+
+private:
+    viau::shm::Segment* segment = nullptr;
+    std::atomic<viau::shm::Slot*> slot{ nullptr };
+    juce::String name;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SharedMeterExport)
+};
@@ -0,0 +1,251 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <limits>
+
+// Layout of the POSIX shared-memory segment through which ViaU instances publish their meters
+// to external readers such as dashboards (see Tools/ViaUMeterReader.cpp). Plain C++17 with no
+// JUCE dependency, so other programs can include this file as it is.
+//
+//   shm_open(viau::shm::segmentName)  ->  Segment { Header, Slot[maxSlots] }
+//
+// Each plugin instance claims one slot by swapping its owner token into Slot::owner, and is
+// then the only writer of that slot. Slots are seqlocks: the writer makes the sequence odd,
+// updates the payload and makes it even again; a reader copies the payload and retries if
+// the sequence was odd or moved meanwhile. Readers never block the writer, and reading
+// hundreds of slots is a few microseconds of plain loads, with no copying beyond the payload
+// itself.
+//
+// Every shared field is a lock-free std::atomic accessed with relaxed ordering, and the
+// fences in writeSlot()/readSlot() order them. That keeps the protocol well defined across
+// processes, and it compiles to ordinary loads and stores on x86 and ARM.
+namespace viau::shm
+{
+    constexpr const char* segmentName = "/viau-meters";
+    constexpr std::uint32_t magic = 0x56694155;         // "ViAU"
+    constexpr std::uint32_t version = 1;
+    constexpr int maxSlots = 512;
+    constexpr int maxChannels = 64;
+    constexpr int nameLength = 64;                      // bytes, including the terminator
+
+    // Owner tokens: (pid << 32) | per-process instance number. 0 marks a free slot.
+    inline std::uint32_t ownerPid(std::uint64_t owner) noexcept { return (std::uint32_t)(owner >> 32); }
+
+    // Publish time base. steady_clock is CLOCK_MONOTONIC on Linux and the uptime clock on
+    // macOS, so values from different processes on one machine can be compared.
+    inline std::uint64_t nowNs() noexcept
+    {
+        return (std::uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // One meter reading, as written by the plugin and returned to readers
+    struct MeterData
+    {
+        std::uint64_t publishTimeNs = 0;
+        std::int64_t samplePosition = 0;
+        double sampleRate = 0.0;
+        bool active = false;                            // export switched on in this instance
+        bool idle = false;                              // input silent, meter at rest
+        bool peakHit = false;
+        float vu = -20.0f;
+        float peak = 0.0f;                              // linear, loudest channel in the block
+        float momentary = -std::numeric_limits<float>::infinity();     // LUFS, -inf if not measured
+        float shortTerm = -std::numeric_limits<float>::infinity();
+        float integrated = -std::numeric_limits<float>::infinity();
+        float loudnessRange = 0.0f;                     // LU
+        int numChannels = 0;
+        float channelVU[maxChannels] {};
+        float channelPeak[maxChannels] {};
+    };
+
+    struct alignas(64) Slot
+    {
+        std::atomic<std::uint64_t> owner;
+        std::atomic<std::uint32_t> nameSequence;        // seqlock for the name (message thread)
+        std::atomic<std::uint64_t> name[nameLength / 8];
+
+        alignas(64) std::atomic<std::uint32_t> sequence; // seqlock for everything below (audio thread)
+        std::atomic<std::uint64_t> publishTimeNs;
+        std::atomic<std::int64_t> samplePosition;
+        std::atomic<double> sampleRate;
+        std::atomic<std::uint32_t> flags;               // bit 0 active, 1 idle, 2 peakHit
+        std::atomic<float> vu, peak;
+        std::atomic<float> momentary, shortTerm, integrated, loudnessRange;
+        std::atomic<std::int32_t> numChannels;
+        std::atomic<float> channelVU[maxChannels];
+        std::atomic<float> channelPeak[maxChannels];
+    };
+
+    struct Header
+    {
+        std::atomic<std::uint32_t> magic;               // written last, once the rest is valid
+        std::atomic<std::uint32_t> version;
+        std::atomic<std::uint32_t> numSlots;
+        std::atomic<std::uint32_t> slotSize;
+    };
+
+    struct Segment
+    {
+        alignas(64) Header header;
+        Slot slots[maxSlots];
+    };
+
+    static_assert(std::atomic<std::uint64_t>::is_always_lock_free && std::atomic<double>::is_always_lock_free
+                      && std::atomic<float>::is_always_lock_free && std::atomic<std::uint32_t>::is_always_lock_free,
+                  "Shared-memory atomics must be lock-free to work across processes");
+
+    // Fills in the header of a freshly created (zeroed) segment. Every process writes the same
+    // values, so racing creators are harmless.
+    inline void initialise(Segment& segment) noexcept
+    {
+        segment.header.version.store(version, std::memory_order_relaxed);
+        segment.header.numSlots.store((std::uint32_t)maxSlots, std::memory_order_relaxed);
+        segment.header.slotSize.store((std::uint32_t)sizeof(Slot), std::memory_order_relaxed);
+        segment.header.magic.store(magic, std::memory_order_release);
+    }
+
+    inline bool isCompatible(const Segment& segment) noexcept
+    {
+        return segment.header.magic.load(std::memory_order_acquire) == magic
+            && segment.header.version.load(std::memory_order_relaxed) == version
+            && segment.header.numSlots.load(std::memory_order_relaxed) == (std::uint32_t)maxSlots
+            && segment.header.slotSize.load(std::memory_order_relaxed) == (std::uint32_t)sizeof(Slot);
+    }
+
+    //==============================================================================
+    // New owner only, right after claiming the slot. A previous owner that died inside
+    // writeSlot() or writeName() left its sequence odd, and every later write would keep it
+    // odd, so readers would see the slot as busy for good. Rounding up to even closes the
+    // abandoned write; readers that copied during it see the sequence move and retry.
+    inline void resetSequences(Slot& slot) noexcept
+    {
+        for (auto* sequence : { &slot.sequence, &slot.nameSequence })
+        {
+            const auto seq = sequence->load(std::memory_order_relaxed);
+            if ((seq & 1) != 0)
+                sequence->store(seq + 1, std::memory_order_release);
+        }
+    }
+
+    // Slot owner only. Wait-free.
+    inline void writeSlot(Slot& slot, const MeterData& data) noexcept
+    {
+        constexpr auto relaxed = std::memory_order_relaxed;
+        const auto seq = slot.sequence.load(relaxed);
+        slot.sequence.store(seq + 1, relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        slot.publishTimeNs.store(data.publishTimeNs, relaxed);
+        slot.samplePosition.store(data.samplePosition, relaxed);
+        slot.sampleRate.store(data.sampleRate, relaxed);
+        slot.flags.store((data.active ? 1u : 0u) | (data.idle ? 2u : 0u) | (data.peakHit ? 4u : 0u), relaxed);
+        slot.vu.store(data.vu, relaxed);
+        slot.peak.store(data.peak, relaxed);
+        slot.momentary.store(data.momentary, relaxed);
+        slot.shortTerm.store(data.shortTerm, relaxed);
+        slot.integrated.store(data.integrated, relaxed);
+        slot.loudnessRange.store(data.loudnessRange, relaxed);
+
+        const int numChannels = data.numChannels < 0 ? 0 : (data.numChannels > maxChannels ? maxChannels : data.numChannels);
+        slot.numChannels.store(numChannels, relaxed);
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            slot.channelVU[ch].store(data.channelVU[ch], relaxed);
+            slot.channelPeak[ch].store(data.channelPeak[ch], relaxed);
+        }
+
+        slot.sequence.store(seq + 2, std::memory_order_release);
+    }
+
+    // Any process. Returns false if the writer kept the slot busy for maxAttempts tries.
+    inline bool readSlot(const Slot& slot, MeterData& data, int maxAttempts = 64) noexcept
+    {
+        constexpr auto relaxed = std::memory_order_relaxed;
+
+        for (int attempt = 0; attempt < maxAttempts; ++attempt)
+        {
+            const auto before = slot.sequence.load(std::memory_order_acquire);
+            if ((before & 1) != 0)
+                continue;
+
+            data.publishTimeNs = slot.publishTimeNs.load(relaxed);
+            data.samplePosition = slot.samplePosition.load(relaxed);
+            data.sampleRate = slot.sampleRate.load(relaxed);
+            const auto flags = slot.flags.load(relaxed);
+            data.active = (flags & 1u) != 0;
+            data.idle = (flags & 2u) != 0;
+            data.peakHit = (flags & 4u) != 0;
+            data.vu = slot.vu.load(relaxed);
+            data.peak = slot.peak.load(relaxed);
+            data.momentary = slot.momentary.load(relaxed);
+            data.shortTerm = slot.shortTerm.load(relaxed);
+            data.integrated = slot.integrated.load(relaxed);
+            data.loudnessRange = slot.loudnessRange.load(relaxed);
+
+            const int numChannels = slot.numChannels.load(relaxed);
+            data.numChannels = numChannels < 0 ? 0 : (numChannels > maxChannels ? maxChannels : numChannels);
+            for (int ch = 0; ch < data.numChannels; ++ch)
+            {
+                data.channelVU[ch] = slot.channelVU[ch].load(relaxed);
+                data.channelPeak[ch] = slot.channelPeak[ch].load(relaxed);
+            }
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(relaxed) == before)
+                return true;
+        }
+
+        return false;
+    }
+
+    //==============================================================================
+    // The display name has its own seqlock, because it is written by a different thread.
+    inline void writeName(Slot& slot, const char* name) noexcept
+    {
+        char bytes[nameLength] {};
+        std::strncpy(bytes, name, nameLength - 1);
+
+        const auto seq = slot.nameSequence.load(std::memory_order_relaxed);
+        slot.nameSequence.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        for (int i = 0; i < nameLength / 8; ++i)
+        {
+            std::uint64_t word;
+            std::memcpy(&word, bytes + i * 8, 8);
+            slot.name[i].store(word, std::memory_order_relaxed);
+        }
+
+        slot.nameSequence.store(seq + 2, std::memory_order_release);
+    }
+
+    inline bool readName(const Slot& slot, char (&dest)[nameLength], int maxAttempts = 64) noexcept
+    {
+        for (int attempt = 0; attempt < maxAttempts; ++attempt)
+        {
+            const auto before = slot.nameSequence.load(std::memory_order_acquire);
+            if ((before & 1) != 0)
+                continue;
+
+            for (int i = 0; i < nameLength / 8; ++i)
+            {
+                const auto word = slot.name[i].load(std::memory_order_relaxed);
+                std::memcpy(dest + i * 8, &word, 8);
+            }
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.nameSequence.load(std::memory_order_relaxed) == before)
+            {
+                dest[nameLength - 1] = 0;
+                return true;
+            }
+        }
+
+        dest[0] = 0;
+        return false;
+    }
+}
@@ -0,0 +1,219 @@
+#include "SpectrumAnalyser.h"
+#include <cmath>
+
+void SpectrumAnalyser::prepare(double newSampleRate)
+{
+    sampleRate = newSampleRate;
+    fftOrder = sampleRate > 100000.0 ? 14 : (sampleRate > 50000.0 ? 13 : 12);
+    fftSize = 1 << fftOrder;
+    fft = std::make_unique<juce::dsp::FFT>(fftOrder);
+
+    window.assign((size_t)fftSize, 0.0f);
+    juce::dsp::WindowingFunction<float>::fillWindowingTables(window.data(), (size_t)fftSize,
+                                                             juce::dsp::WindowingFunction<float>::hann, false);
+
+    // Parseval: the positive-frequency bins of a windowed sine of amplitude A hold
+    // N * A^2 / 4 * sum(w^2) between them
+    double sumOfSquares = 0.0;
+    for (auto w : window)
+        sumOfSquares += (double)w * (double)w;
+    powerScale = (float)(4.0 / ((double)fftSize * sumOfSquares));
+
+    input.assign((size_t)fftSize, 0.0f);
+    fftData.assign((size_t)fftSize * 2, 0.0f);
+
+    buildBandTable(octaveBands, 1);
+    buildBandTable(thirdOctaveBands, 3);
+    selectBandTable();
+    updateCoefficients();
+    reset();
+}
+
+void SpectrumAnalyser::reset() noexcept
+{
+    std::fill(input.begin(), input.end(), 0.0f);
+    writePosition = 0;
+    hopFill = 0;
+    silentSamples = fftSize;
+    atRest = true;
+    bandPowers.fill(0.0);
+
+    for (auto& level : bandLevels)
+        level.store(floorDb, std::memory_order_relaxed);
+}
+
+// Centres on the base-2 grid through 1 kHz: 31.25 Hz to 16 kHz in octaves, 24.8 Hz to
+// 20.2 kHz in thirds, minus any band that starts above Nyquist
+void SpectrumAnalyser::buildBandTable(BandTable& table, int bandsPerOctaveToUse) const
+{
+    const double binHz = sampleRate / (double)fftSize;
+    const double nyquist = sampleRate * 0.5;
+    const int numBins = fftSize / 2;
+    const int first = bandsPerOctaveToUse == 1 ? -5 : -16;
+    const int last = bandsPerOctaveToUse == 1 ? 4 : 13;
+
+    table.numBands = 0;
+
+    for (int k = first; k <= last && table.numBands < maxBands; ++k)
+    {
+        const double centre = 1000.0 * std::pow(2.0, (double)k / bandsPerOctaveToUse);
+        const double halfWidth = std::pow(2.0, 0.5 / bandsPerOctaveToUse);
+        const double lower = centre / halfWidth;
+
+        if (lower >= nyquist)
+            break;
+
+        int firstBin = (int)std::ceil(lower / binHz);
+        int endBin = juce::jmin(numBins, (int)std::ceil(centre * halfWidth / binHz));
+
+        if (endBin <= firstBin)
+        {
+            firstBin = juce::jlimit(1, numBins - 1, juce::roundToInt(centre / binHz));
+            endBin = firstBin + 1;
+        }
+
+        table.bands[(size_t)table.numBands++] = { firstBin, endBin - firstBin, (float)centre };
+    }
+}
+
+void SpectrumAnalyser::selectBandTable() noexcept
+{
+    activeTable = bandsPerOctave == 1 ? &octaveBands : &thirdOctaveBands;
+    bandPowers.fill(0.0);
+
+    for (int b = 0; b < activeTable->numBands; ++b)
+    {
+        bandCentres[(size_t)b].store(activeTable->bands[(size_t)b].centreHz, std::memory_order_relaxed);
+        bandLevels[(size_t)b].store(floorDb, std::memory_order_relaxed);
+    }
+
+    numBands.store(activeTable->numBands, std::memory_order_release);
+}
+
+void SpectrumAnalyser::updateCoefficients() noexcept
+{
+    hopSize = fftSize / hopDivisor;
+    hopFill = juce::jmin(hopFill, hopSize - 1);
+
+    const double hopSeconds = (double)hopSize / sampleRate;
+    attackCoeff = 1.0 - std::exp(-hopSeconds / attackSeconds);
+    releaseFactor = std::pow(10.0, -releaseDbPerSecond * hopSeconds / 10.0);
+}
+
+void SpectrumAnalyser::setBandsPerOctave(int newBandsPerOctave) noexcept
+{
+    newBandsPerOctave = newBandsPerOctave == 1 ? 1 : 3;
+
+    if (newBandsPerOctave != bandsPerOctave)
+    {
+        bandsPerOctave = newBandsPerOctave;
+        selectBandTable();
+    }
+}
+
+void SpectrumAnalyser::setHopDivisor(int newHopDivisor) noexcept
+{
+    newHopDivisor = juce::jlimit(1, 8, newHopDivisor);
+
+    if (newHopDivisor != hopDivisor)
+    {
+        hopDivisor = newHopDivisor;
+        updateCoefficients();
+    }
+}
+
+void SpectrumAnalyser::process(const float* const* channels, int numChannels, int numSamples) noexcept
+{
+    if (numChannels <= 0)
+    {
+        processSilence(numSamples);
+        return;
+    }
+
+    const float gain = 1.0f / (float)numChannels;
+    silentSamples = 0;
+
+    feed(numSamples, [&](float* dest, int offset, int num)
+        {
+            juce::FloatVectorOperations::copyWithMultiply(dest, channels[0] + offset, gain, num);
+            for (int ch = 1; ch < numChannels; ++ch)
+                juce::FloatVectorOperations::addWithMultiply(dest, channels[ch] + offset, gain, num);
+        });
+}
+
+void SpectrumAnalyser::processSilence(int numSamples) noexcept
+{
+    // With a whole frame of zeros in the ring and every band down at the floor, more zeros
+    // would not change anything
+    if (silentSamples >= fftSize && atRest)
+        return;
+
+    feed(numSamples, [](float* dest, int, int num) { juce::FloatVectorOperations::clear(dest, num); });
+    silentSamples = juce::jmin(fftSize, silentSamples + numSamples);
+}
+
+template <typename FillFn>
+void SpectrumAnalyser::feed(int numSamples, FillFn&& fill) noexcept
+{
+    if (fft == nullptr)
+        return;
+
+    for (int done = 0; done < numSamples;)
+    {
+        const int num = juce::jmin(numSamples - done, hopSize - hopFill, fftSize - writePosition);
+        fill(input.data() + writePosition, done, num);
+
+        writePosition = (writePosition + num) % fftSize;
+        hopFill += num;
+        done += num;
+
+        if (hopFill == hopSize)
+        {
+            hopFill = 0;
+            computeFrame();
+        }
+    }
+}
+
+void SpectrumAnalyser::computeFrame() noexcept
+{
+    // Unroll the ring, oldest sample first
+    const auto oldest = input.begin() + writePosition;
+    std::copy(oldest, input.end(), fftData.begin());
+    std::copy(input.begin(), oldest, fftData.begin() + (fftSize - writePosition));
+
+    juce::FloatVectorOperations::multiply(fftData.data(), window.data(), fftSize);
+    juce::FloatVectorOperations::clear(fftData.data() + fftSize, fftSize);
+    fft->performFrequencyOnlyForwardTransform(fftData.data(), true);
+
+    const auto& table = *activeTable;
+    bool allAtFloor = true;
+
+    for (int b = 0; b < table.numBands; ++b)
+    {
+        const auto& band = table.bands[(size_t)b];
+        double power = 0.0;
+
+        for (int bin = band.firstBin; bin < band.firstBin + band.numBins; ++bin)
+            power += (double)fftData[(size_t)bin] * (double)fftData[(size_t)bin];
+
+        power *= (double)powerScale;
+
+        auto& smoothed = bandPowers[(size_t)b];
+        smoothed = power > smoothed ? smoothed + attackCoeff * (power - smoothed)
+                                    : juce::jmax(power, smoothed * releaseFactor);
+
+        float db = smoothed > 0.0 ? (float)(10.0 * std::log10(smoothed)) : floorDb;
+        if (db <= floorDb)
+        {
+            // Snapping to zero keeps the release out of the denormal range
+            smoothed = 0.0;
+            db = floorDb;
+        }
+
+        allAtFloor = allAtFloor && smoothed == 0.0;
+        bandLevels[(size_t)b].store(db, std::memory_order_relaxed);
+    }
+
+    atRest = allAtFloor;
+}
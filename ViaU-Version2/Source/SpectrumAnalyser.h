@@ -0,0 +1,98 @@
+#pragma once
+#include <juce_dsp/juce_dsp.h>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+// Octave / third-octave band levels from a Hann-windowed FFT of the channel average.
+//
+// The FFT is 4096 points at 44.1/48 kHz (8192 up to 96 kHz, 16384 above), about 11.7 Hz per
+// bin. A new frame is taken every fftSize / hopDivisor samples, so the hop trades time
+// resolution against CPU. Each band sums the power of the bins whose centre frequency falls
+// inside it. Bands too narrow to hold a bin (the lowest third octaves) read the bin nearest
+// their centre. Both band tables are built in prepare().
+//
+// Band power gets PPM-style ballistics per frame: 10 ms integration on the way up, a fall of
+// 20 dB/s on the way down. Levels are in dBFS, with a full-scale sine reading 0 dB in its band.
+//
+// process() runs on one thread (ViaU's analysis worker) and neither allocates nor locks. The
+// FFT works in place in a preallocated buffer, and JUCE's fallback engine keeps its scratch on
+// the stack at these sizes. The levels are published through atomics.
+class SpectrumAnalyser
+{
+public:
+    static constexpr int maxBands = 32;
+    static constexpr float floorDb = -90.0f;
+    static constexpr double attackSeconds = 0.010;
+    static constexpr double releaseDbPerSecond = 20.0;
+
+    SpectrumAnalyser() = default;
+
+    void prepare(double sampleRate);
+    void reset() noexcept;
+
+    // Processing thread. Changes take effect at the next frame.
+    void setBandsPerOctave(int newBandsPerOctave) noexcept;     // 1 or 3
+    void setHopDivisor(int newHopDivisor) noexcept;             // 1 (no overlap) .. 8
+
+    void process(const float* const* channels, int numChannels, int numSamples) noexcept;
+    void processSilence(int numSamples) noexcept;
+
+    // Any thread
+    int getNumBands() const noexcept { return numBands.load(std::memory_order_acquire); }
+    float getBandLevel(int band) const noexcept { return bandLevels[(size_t)band].load(std::memory_order_relaxed); }
+    float getBandCentre(int band) const noexcept { return bandCentres[(size_t)band].load(std::memory_order_relaxed); }
+
+private:
+    struct Band
+    {
+        int firstBin = 0;
+        int numBins = 0;
+        float centreHz = 0.0f;
+    };
+
+    struct BandTable
+    {
+        std::array<Band, maxBands> bands {};
+        int numBands = 0;
+    };
+
+    void buildBandTable(BandTable& table, int bandsPerOctave) const;
+    void selectBandTable() noexcept;
+    void updateCoefficients() noexcept;
+
+    // Mixes or clears up to the next frame boundary, then runs the frame
+    template <typename FillFn>
+    void feed(int numSamples, FillFn&& fill) noexcept;
+    void computeFrame() noexcept;
+
+    double sampleRate = 48000.0;
+    int fftOrder = 12;
+    int fftSize = 4096;
+    std::unique_ptr<juce::dsp::FFT> fft;
+    std::vector<float> window;
+    std::vector<float> input;                           // circular, fftSize samples of the mono mix
+    std::vector<float> fftData;                         // 2 * fftSize, as performFrequencyOnlyForwardTransform needs
+    float powerScale = 1.0f;                            // one-sided bin power -> sine amplitude squared
+    int writePosition = 0;
+    int hopSize = 1024;
+    int hopFill = 0;
+    int silentSamples = 0;                              // zeros fed since the last signal
+    bool atRest = true;                                 // every band at the floor
+
+    BandTable octaveBands, thirdOctaveBands;
+    const BandTable* activeTable = &thirdOctaveBands;
+    int bandsPerOctave = 3;
+    int hopDivisor = 4;
+
+    double attackCoeff = 1.0;
+    double releaseFactor = 1.0;
+    std::array<double, maxBands> bandPowers {};
+
+    std::atomic<int> numBands{ 0 };
+    std::array<std::atomic<float>, maxBands> bandLevels {};
+    std::array<std::atomic<float>, maxBands> bandCentres {};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SpectrumAnalyser)
+};
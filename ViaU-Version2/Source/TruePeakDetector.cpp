@@ -0,0 +1,197 @@
+#include "TruePeakDetector.h"
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+
+#if JUCE_USE_SSE_INTRINSICS
+ #include <emmintrin.h>
+#elif JUCE_USE_ARM_NEON
+ #include <arm_neon.h>
+#endif
+
+namespace
+{
+    // Zeroth-order modified Bessel function, for the Kaiser window
+    double besselI0(double x)
+    {
+        double sum = 1.0, term = 1.0;
+        for (int k = 1; k < 32; ++k)
+        {
+            term *= (x / (2.0 * k)) * (x / (2.0 * k));
+            sum += term;
+        }
+        return sum;
+    }
+}
+
+TruePeakDetector::TruePeakDetector()
+{
+    // Kaiser-windowed sinc interpolator centred on tap 24. Phase 0 then reproduces the input
+    // sample exactly, so the true peak can never read below the sample peak.
+    constexpr int numTaps = oversampling * tapsPerPhase;
+    constexpr double centre = numTaps / 2;
+    constexpr double beta = 6.0;
+
+    std::array<double, numTaps> h {};
+    for (int i = 0; i < numTaps; ++i)
+    {
+        const double t = ((double)i - centre) / oversampling;
+        const double sinc = t == 0.0 ? 1.0 : std::sin(juce::MathConstants<double>::pi * t) / (juce::MathConstants<double>::pi * t);
+        const double r = ((double)i - centre) / centre;
+        h[(size_t)i] = sinc * besselI0(beta * std::sqrt(juce::jmax(0.0, 1.0 - r * r))) / besselI0(beta);
+    }
+
+    // Unity DC gain per phase
+    for (int p = 0; p < oversampling; ++p)
+    {
+        double sum = 0.0;
+        for (int k = 0; k < tapsPerPhase; ++k)
+            sum += h[(size_t)(p + oversampling * k)];
+        for (int k = 0; k < tapsPerPhase; ++k)
+            coeffs[(size_t)k][(size_t)p] = (float)(h[(size_t)(p + oversampling * k)] / sum);
+    }
+}
+
+void TruePeakDetector::prepare(int maxBlockSize)
+{
+    capacity = juce::jmax(1, maxBlockSize);
+    scratch.assign((size_t)(capacity + tapsPerPhase - 1), 0.0f);
+    clippedFrames.assign((size_t)capacity, 0);
+    reset();
+}
+
+void TruePeakDetector::reset() noexcept
+{
+    for (auto& h : history)
+        h.fill(0.0f);
+}
+
+void TruePeakDetector::process(const float* const* channels, int numChannels, int numSamples) noexcept
+{
+    processChannels(channels, numChannels, numSamples);
+}
+
+void TruePeakDetector::process(const double* const* channels, int numChannels, int numSamples) noexcept
+{
+    processChannels(channels, numChannels, numSamples);
+}
+
+template <typename SampleType>
+void TruePeakDetector::processChannels(const SampleType* const* channels, int numChannels, int numSamples) noexcept
+{
+    numChannels = juce::jmin(numChannels, maxChannels);
+    std::array<float, maxChannels> blockPeaks {};
+    juce::uint64 clips = 0;
+
+    // Hosts may exceed the prepared block size; fall back to capacity-sized chunks. Every
+    // channel of a chunk is done before the next, so its frames are counted as clipped once.
+    for (int start = 0; start < numSamples; start += capacity)
+    {
+        const int n = juce::jmin(capacity, numSamples - start);
+        std::fill_n(clippedFrames.begin(), n, (juce::uint8)0);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            auto& channelHistory = history[(size_t)ch];
+            std::copy(channelHistory.begin(), channelHistory.end(), scratch.begin());
+
+            if constexpr (std::is_same<SampleType, float>::value)
+                juce::FloatVectorOperations::copy(scratch.data() + tapsPerPhase - 1, channels[ch] + start, n);
+            else
+                std::copy(channels[ch] + start, channels[ch] + start + n, scratch.begin() + tapsPerPhase - 1);
+
+            blockPeaks[(size_t)ch] = juce::jmax(blockPeaks[(size_t)ch],
+                                                processChannel(scratch.data() + tapsPerPhase - 1, n, clippedFrames.data()));
+
+            std::copy(scratch.begin() + n, scratch.begin() + n + tapsPerPhase - 1, channelHistory.begin());
+        }
+
+        clips += (juce::uint64)std::count(clippedFrames.begin(), clippedFrames.begin() + n, (juce::uint8)1);
+    }
+
+    // Fold into the values the editor has not collected yet
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        const float blockPeak = blockPeaks[(size_t)ch];
+        auto& published = channelPeaks[(size_t)ch];
+        for (float current = published.load(std::memory_order_relaxed);
+             blockPeak > current && !published.compare_exchange_weak(current, blockPeak, std::memory_order_relaxed);)
+        {
+        }
+    }
+
+    if (clips > 0)
+        clipCount.fetch_add(clips, std::memory_order_relaxed);
+}
+
+float TruePeakDetector::processChannel(const float* x, int numSamples, juce::uint8* clipped) const noexcept
+{
+   #if JUCE_USE_SSE_INTRINSICS
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    const __m128 one = _mm_set1_ps(1.0f);
+    __m128 peak = _mm_setzero_ps();
+
+    __m128 c[tapsPerPhase];
+    for (int k = 0; k < tapsPerPhase; ++k)
+        c[k] = _mm_load_ps(coeffs[(size_t)k].data());
+
+    for (int n = 0; n < numSamples; ++n)
+    {
+        __m128 y = _mm_mul_ps(c[0], _mm_set1_ps(x[n]));
+        for (int k = 1; k < tapsPerPhase; ++k)
+            y = _mm_add_ps(y, _mm_mul_ps(c[k], _mm_set1_ps(x[n - k])));
+
+        y = _mm_and_ps(y, absMask);
+        peak = _mm_max_ps(peak, y);
+
+        clipped[n] |= (juce::uint8)(_mm_movemask_ps(_mm_cmpgt_ps(y, one)) != 0);
+    }
+
+    alignas(16) float lanes[4];
+    _mm_store_ps(lanes, peak);
+    return juce::jmax(lanes[0], lanes[1], lanes[2], lanes[3]);
+   #elif JUCE_USE_ARM_NEON
+    const float32x4_t one = vdupq_n_f32(1.0f);
+    float32x4_t peak = vdupq_n_f32(0.0f);
+
+    float32x4_t c[tapsPerPhase];
+    for (int k = 0; k < tapsPerPhase; ++k)
+        c[k] = vld1q_f32(coeffs[(size_t)k].data());
+
+    for (int n = 0; n < numSamples; ++n)
+    {
+        float32x4_t y = vmulq_n_f32(c[0], x[n]);
+        for (int k = 1; k < tapsPerPhase; ++k)
+            y = vmlaq_n_f32(y, c[k], x[n - k]);
+
+        y = vabsq_f32(y);
+        peak = vmaxq_f32(peak, y);
+
+        const uint32x4_t over = vshrq_n_u32(vcgtq_f32(y, one), 31);
+        const uint32x2_t pair = vmax_u32(vget_low_u32(over), vget_high_u32(over));
+        clipped[n] |= (juce::uint8)vget_lane_u32(vpmax_u32(pair, pair), 0);
+    }
+
+    const float32x2_t half = vmax_f32(vget_low_f32(peak), vget_high_f32(peak));
+    return vget_lane_f32(vpmax_f32(half, half), 0);
+   #else
+    float peak = 0.0f;
+
+    for (int n = 0; n < numSamples; ++n)
+    {
+        for (int p = 0; p < oversampling; ++p)
+        {
+            float y = 0.0f;
+            for (int k = 0; k < tapsPerPhase; ++k)
+                y += coeffs[(size_t)k][(size_t)p] * x[n - k];
+
+            y = std::abs(y);
+            peak = juce::jmax(peak, y);
+            if (y > 1.0f)
+                clipped[n] = 1;
+        }
+    }
+
+    return peak;
+   #endif
+}
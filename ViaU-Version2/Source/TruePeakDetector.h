@@ -0,0 +1,60 @@
+#pragma once
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <array>
+#include <atomic>
+#include <vector>
+
+// ITU-R BS.1770 style true-peak detector.
+//
+// Each channel is upsampled 4x by a 48-tap polyphase interpolator (12 taps per phase). The
+// kernel computes all four phases of one input sample in a single SIMD register, so the cost
+// is 12 vector multiply-adds per input sample and channel (well under 0.1 % of a core for a
+// stereo instance at 48 kHz).
+//
+// The processing thread (ViaU's analysis worker) folds each block's per-channel maxima into atomics. The editor collects
+// them with popChannelPeak(), which returns the maximum since its previous call.
+class TruePeakDetector
+{
+public:
+    static constexpr int oversampling = 4;
+    static constexpr int tapsPerPhase = 12;
+    static constexpr int maxChannels = 64;
+
+    TruePeakDetector();
+
+    void prepare(int maxBlockSize);
+    void reset() noexcept;
+
+    // Processing thread. Double input is narrowed while it is copied into the scratch buffer, which
+    // the float path copies into anyway, so it costs no extra pass.
+    void process(const float* const* channels, int numChannels, int numSamples) noexcept;
+    void process(const double* const* channels, int numChannels, int numSamples) noexcept;
+
+    // Message thread. The clip count is of input sample frames in which any channel's 4x
+    // upsampled signal goes above 0 dBFS, however many channels and phases do.
+    float popChannelPeak(int ch) noexcept { return channelPeaks[(size_t)ch].exchange(0.0f); }
+    juce::uint64 getClipCount() const noexcept { return clipCount.load(); }
+    void resetClipCount() noexcept { clipCount.store(0); }
+
+private:
+    template <typename SampleType>
+    void processChannels(const SampleType* const* channels, int numChannels, int numSamples) noexcept;
+
+    // Returns max |y| over the 4x upsampled block and sets clipped[n] to 1 where input sample n
+    // interpolates above 0 dBFS, leaving the other flags as they are. x points at the first
+    // new sample and must have tapsPerPhase - 1 samples of history before it.
+    float processChannel(const float* x, int numSamples, juce::uint8* clipped) const noexcept;
+
+    // coeffs[k][p] = h[p + oversampling * k], i.e. tap k of every phase side by side
+    alignas(16) std::array<std::array<float, oversampling>, tapsPerPhase> coeffs {};
+
+    std::array<std::array<float, tapsPerPhase - 1>, maxChannels> history {};
+    std::vector<float> scratch;     // history + one block of the channel being processed
+    std::vector<juce::uint8> clippedFrames;     // per frame of the chunk being processed
+    int capacity = 0;
+
+    std::array<std::atomic<float>, maxChannels> channelPeaks {};
+    std::atomic<juce::uint64> clipCount{ 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TruePeakDetector)
+};
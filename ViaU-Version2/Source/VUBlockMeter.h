@@ -0,0 +1,44 @@
+#pragma once
+#include "../../ViaU-Common/MeteringCore.h"
+#include "VUScale.h"
+
+// One block of the VU meter, as ViaUAudioProcessor::processSamples publishes it. The batch
+// analyser (Tools/ViaUBatchAnalyzer.cpp) goes through the same function, so its readings are
+// the plugin's: a silent block only decays the integrator, which snaps to zero and reports
+// itself at rest once it is below the scale, the reading is the main group's level on the
+// scale, and the peak indicator lights from VUScale::peakVU.
+namespace viau
+{
+    // Blocks whose peak is below this (under the 24-bit LSB) count as digital silence
+    constexpr float silenceThreshold = 1.0e-8f;
+
+    template <typename SampleType>
+    struct VUBlockReading
+    {
+        SampleType level = 0;               // main group, linear
+        float vu = 0.0f;
+        bool peakHit = false;
+        bool atRest = false;                // silent and settled below the scale
+    };
+
+    // The main group is the first numMain of the numMetered channels; the rest (the reference
+    // bus, in the plugin) go through the same pass and are read back by the caller. silent
+    // means every metered channel is below silenceThreshold for the whole block. floorGain is
+    // scale.getFloorGain(), which callers keep rather than recompute every block.
+    template <typename MeterType, typename SampleType>
+    VUBlockReading<SampleType> meterVUBlock(MeterType& meter, const VUScale& scale, double floorGain, const SampleType* const* channels,
+                                            int numMetered, int numMain, int numSamples, bool silent) noexcept
+    {
+        VUBlockReading<SampleType> reading;
+
+        if (silent)
+            reading.atRest = meter.processSilence(numMetered, numSamples, (SampleType)floorGain);
+        else
+            meter.process(channels, numMetered, numSamples); // channel-major, see MeteringCore.h
+
+        reading.level = meter.getGroupLevel(0, numMain);
+        reading.vu = scale.fromLinear(reading.level);
+        reading.peakHit = reading.vu >= VUScale::peakVU;
+        return reading;
+    }
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <cmath>
+#include <type_traits>
+
+// The VU scale: where 0 VU sits in dBFS and the span of the meter, in VU units.
+//
+// The processor turns detector levels into readings with it, and the editor places them on
+// screen with it, so both always agree. The values come from the "referenceLevel",
+// "scaleFloor" and "scaleCeiling" parameters (see ViaUAudioProcessor::getScale()). The
+// defaults are the classic calibration: 0 VU = -18 dBFS on a -20..+3 scale.
+struct VUScale
+{
+    float referenceDbfs = -18.0f;
+    float minVU = -20.0f;
+    float maxVU = 3.0f;
+
+    // Readings at or above this light the peak indicator. The ceiling never goes below it.
+    static constexpr float peakVU = 0.0f;
+
+    // Linear level -> VU units, clamped to the scale. The double path keeps its state well
+    // below float's floor, so its epsilon is correspondingly lower.
+    template <typename SampleType>
+    float fromLinear(SampleType linear) const noexcept
+    {
+        constexpr SampleType eps = std::is_same<SampleType, double>::value ? (SampleType)1.0e-15 : (SampleType)1.0e-9;
+        return fromDbfs((float)juce::Decibels::gainToDecibels(linear + eps));
+    }
+
+    float fromDbfs(float dbfs) const noexcept { return juce::jlimit(minVU, maxVU, dbfs - referenceDbfs); }
+
+    // Linear level at the bottom of the scale
+    double getFloorGain() const noexcept { return std::pow(10.0, (double)(minVU + referenceDbfs) / 20.0); }
+
+    // Colour zones, measured down from the top of the scale so they move with the ceiling:
+    // amber from getCautionVU(), red from getWarningVU(). -6 and -3 VU on the default scale.
+    float getCautionVU() const noexcept { return juce::jmax(minVU, maxVU - 9.0f); }
+    float getWarningVU() const noexcept { return juce::jmax(minVU, maxVU - 6.0f); }
+
+    // Position along the scale, 0 at the bottom and 1 at the top
+    float toNorm(float vu) const noexcept { return juce::jlimit(0.0f, 1.0f, (vu - minVU) / (maxVU - minVU)); }
+
+    // Needle angle in radians, sweeping from 230 degrees at the bottom to -50 at the top
+    float toAngle(float vu) const noexcept
+    {
+        return juce::degreesToRadians(juce::jmap(juce::jlimit(minVU, maxVU, vu), minVU, maxVU, 230.0f, -50.0f));
+    }
+
+    bool operator==(const VUScale& other) const noexcept
+    {
+        return referenceDbfs == other.referenceDbfs && minVU == other.minVU && maxVU == other.maxVU;
+    }
+
+    bool operator!=(const VUScale& other) const noexcept { return !operator==(other); }
+};
@@ -0,0 +1,135 @@
+// Round trip of a meter recording (.viaurec, see MeterRecording.h): records written by
+// MeterRecorder, read back by MeterRecordingReader, and found again by host time with
+// findRecord(), both from the index written when recording stops and from the one the reader
+// rebuilds for a file that was never finished.
+//
+// Built with TestMain.cpp on the plugin's sources and run by ctest.
+
+#include "../Source/MeterRecorder.h"
+#include <cstring>
+
+namespace
+{
+    class MeterRecordingTest : public juce::UnitTest
+    {
+    public:
+        MeterRecordingTest() : juce::UnitTest("Meter recording", "MeterRecording") {}
+
+        void runTest() override
+        {
+            const auto records = makeRecords();
+            const juce::TemporaryFile recording(".viaurec");
+
+            beginTest("Round trip");
+            {
+                MeterRecorder recorder;
+                expect(recorder.start(recording.getFile(), sampleRate));
+
+                // Fewer than MeterRecorder::queueCapacity, so none is dropped however late the writer wakes
+                for (const auto& record : records)
+                    recorder.push(record);
+
+                recorder.stop();
+            }
+
+            MeterRecordingReader reader(recording.getFile());
+            expect(reader.isValid());
+            expectEquals(reader.getSampleRate(), sampleRate);
+            expectEquals(reader.getNumRecords(), (juce::int64)records.size());
+            expectEquals(reader.getHeader().numDropped, (juce::int64)0);
+            expectEquals(reader.getHeader().numIndexEntries, (juce::int64)4);
+
+            int numDifferent = 0;
+            for (size_t i = 0; i < records.size() && (juce::int64)i < reader.getNumRecords(); ++i)
+                if (std::memcmp(&reader.getRecord((juce::int64)i), &records[i], sizeof(MeterRecord)) != 0)
+                    ++numDifferent;
+
+            expectEquals(numDifferent, 0, "records read back differently");
+
+            beginTest("Seeking");
+            checkSeeking(reader, records);
+
+            beginTest("Unfinished recording");
+            {
+                // What a crash leaves: the header as start() wrote it, then the records
+                juce::MemoryBlock data;
+                expect(recording.getFile().loadFileAsData(data));
+
+                MeterRecordingHeader header;
+                std::memcpy(&header, data.getData(), sizeof(header));
+                header.numRecords = header.indexOffset = header.numIndexEntries = header.numDropped = 0;
+                std::memcpy(data.getData(), &header, sizeof(header));
+                data.setSize(sizeof(MeterRecordingHeader) + records.size() * sizeof(MeterRecord));
+
+                const juce::TemporaryFile unfinished(".viaurec");
+                expect(unfinished.getFile().replaceWithData(data.getData(), data.getSize()));
+
+                MeterRecordingReader unfinishedReader(unfinished.getFile());
+                expect(unfinishedReader.isValid());
+                expectEquals(unfinishedReader.getNumRecords(), (juce::int64)records.size());
+                checkSeeking(unfinishedReader, records);
+            }
+        }
+
+    private:
+        static constexpr double sampleRate = 48000.0;
+        static constexpr int blockSize = 512;
+        static constexpr int recordsPerIndexEntry = 4096;   // MeterRecordingHeader's default
+        static constexpr juce::int64 firstPassStart = 100000000;
+
+        // Four index entries' worth of blocks: no host time before playback starts, then a
+        // pass with a stretch of blocks without host time in the middle of the second entry,
+        // then a loop jump back to earlier host times in the third. No host time is recorded
+        // twice, so every one belongs to exactly one record.
+        static std::vector<MeterRecord> makeRecords()
+        {
+            std::vector<MeterRecord> records((size_t)(3 * recordsPerIndexEntry + 100));
+
+            for (size_t i = 0; i < records.size(); ++i)
+            {
+                auto& record = records[i];
+                const auto n = (juce::int64)i;
+
+                if (n < 50 || (n >= 5000 && n < 5100))
+                    record.hostSample = -1;
+                else if (n < 9000)
+                    record.hostSample = firstPassStart + n * blockSize;
+                else
+                    record.hostSample = (n - 9000) * blockSize;
+
+                record.processedSample = n * blockSize;
+                record.vu = -20.0f + (float)(i % 23);
+                record.peak = (float)(i % 7) / 7.0f;
+                record.numSamples = (juce::uint32)blockSize;
+                record.flags = (record.hostSample >= 0 ? MeterRecord::playing : 0u) | (record.vu >= 0.0f ? MeterRecord::peakHit : 0u);
+            }
+
+            return records;
+        }
+
+        void checkSeeking(const MeterRecordingReader& reader, const std::vector<MeterRecord>& records)
+        {
+            int numMissed = 0;
+            for (size_t i = 0; i < records.size(); ++i)
+            {
+                const auto start = records[i].hostSample;
+                if (start < 0)
+                    continue;
+
+                for (juce::int64 offset : { 0, blockSize / 2, blockSize - 1 })
+                    if (reader.findRecord(start + offset) != (juce::int64)i)
+                        ++numMissed;
+            }
+
+            expectEquals(numMissed, 0, "host times not found in the record that covers them");
+
+            // Host times no record covers: the stretch without host time, past either pass, and none
+            expectEquals(reader.findRecord(firstPassStart + 5050 * blockSize), (juce::int64)-1);
+            expectEquals(reader.findRecord(firstPassStart + 9000 * blockSize), (juce::int64)-1);
+            expectEquals(reader.findRecord((juce::int64)(records.size() - 9000) * blockSize), (juce::int64)-1);
+            expectEquals(reader.findRecord(-1), (juce::int64)-1);
+        }
+    };
+
+    MeterRecordingTest meterRecordingTest;
+}
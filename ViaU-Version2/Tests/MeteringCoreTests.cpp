@@ -0,0 +1,271 @@
+// Unit tests for the header-only metering core (ViaU-Common/MeteringCore.h): the closed-form
+// block kernels of the one-pole meters, full-rate and decimated, against the scalar
+// sample-by-sample loop Meter::processReference(), and processSilence() against process() on
+// zeros.
+//
+// Built with TestMain.cpp as a console application (juce_audio_basics only) and run by ctest.
+
+#include "../../ViaU-Common/MeteringCore.h"
+#include <random>
+
+namespace
+{
+    // Noise under a slow level envelope, so a meter rises and falls across blocks. Channel ch
+    // is scaled by 1 / (ch + 1); no sample exceeds full scale.
+    template <typename SampleType>
+    class TestSignal
+    {
+    public:
+        TestSignal(int numChannelsToUse, int maxBlockSize)
+            : numChannels(numChannelsToUse), buffer(numChannelsToUse, maxBlockSize) {}
+
+        const SampleType* const* next(int numSamples)
+        {
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                auto* data = buffer.getWritePointer(ch);
+                for (int n = 0; n < numSamples; ++n)
+                {
+                    const double envelope = 0.55 + 0.45 * std::sin((double)(position + n) * 2.0e-4);
+                    data[n] = (SampleType)(envelope * noise(rng) / (double)(ch + 1));
+                }
+            }
+
+            position += numSamples;
+            return buffer.getArrayOfReadPointers();
+        }
+
+    private:
+        int numChannels;
+        juce::AudioBuffer<SampleType> buffer;
+        std::mt19937 rng{ 0x5eed };
+        std::uniform_real_distribution<double> noise{ -1.0, 1.0 };
+        int position = 0;
+    };
+
+    //==============================================================================
+    template <typename Detector, typename SampleType>
+    class BlockKernelTest : public juce::UnitTest
+    {
+    public:
+        explicit BlockKernelTest(const juce::String& name) : juce::UnitTest(name, "MeteringCore") {}
+
+        void runTest() override
+        {
+            // Block sizes a host may pass after prepare(..., preparedBlockSize): odd ones, one
+            // either side of the table size, and several times past it (chunked by process())
+            const int blockSizes[] = { 1, 7, 33, 255, preparedBlockSize - 1, preparedBlockSize, preparedBlockSize + 1,
+                                       3 * preparedBlockSize + 17, 8 * preparedBlockSize + 1 };
+
+            for (double sampleRate : { 44100.0, 48000.0, 192000.0 })
+            {
+                for (double timeConstant : { 0.05, 0.3, 1.0 })
+                {
+                    beginTest(juce::String(sampleRate, 0) + " Hz, " + juce::String(timeConstant * 1000.0, 0) + " ms");
+
+                    checkAgainstReference<1>(sampleRate, timeConstant, blockSizes);
+                    checkAgainstReference<2>(sampleRate, timeConstant, blockSizes);
+                    checkAgainstReference<viau::dynamicChannelCount>(sampleRate, timeConstant, blockSizes);
+                }
+            }
+        }
+
+    private:
+        static constexpr int preparedBlockSize = 512;
+        static constexpr int numDynamicChannels = 5;
+
+        template <int NumChannels, size_t NumSizes>
+        void checkAgainstReference(double sampleRate, double timeConstant, const int (&blockSizes)[NumSizes])
+        {
+            using MeterType = viau::Meter<Detector, viau::OnePoleBallistics<300>, NumChannels, SampleType>;
+            constexpr int numChannels = NumChannels == viau::dynamicChannelCount ? numDynamicChannels : NumChannels;
+
+            MeterType meter;
+            meter.prepare(sampleRate, preparedBlockSize);
+            meter.setTimeConstant(timeConstant);
+
+            TestSignal<SampleType> signal(numChannels, blockSizes[NumSizes - 1]);
+            SampleType reference = 0;
+            double worstDb = 0.0;
+
+            for (int round = 0; round < 4; ++round)
+            {
+                for (int numSamples : blockSizes)
+                {
+                    const auto* const* channels = signal.next(numSamples);
+                    const SampleType level = meter.process(channels, numChannels, numSamples);
+                    reference = MeterType::processReference(reference, meter.getAlpha(), channels, numChannels, numSamples);
+
+                    const double expected = (double)Detector::toLevel(reference);
+                    if (expected > 1.0e-6)
+                        worstDb = juce::jmax(worstDb, std::abs(juce::Decibels::gainToDecibels((double)level / expected)));
+                }
+            }
+
+            expect(worstDb <= MeterType::toleranceDb,
+                   juce::String(numChannels) + " ch: block kernel " + juce::String(worstDb, 4) + " dB from the reference");
+        }
+    };
+
+    BlockKernelTest<viau::AbsDetector, float> absFloatTest("Block kernel, AbsDetector, float");
+    BlockKernelTest<viau::AbsDetector, double> absDoubleTest("Block kernel, AbsDetector, double");
+    BlockKernelTest<viau::RmsDetector, float> rmsFloatTest("Block kernel, RmsDetector, float");
+    BlockKernelTest<viau::RmsDetector, double> rmsDoubleTest("Block kernel, RmsDetector, double");
+
+    //==============================================================================
+    // Decimated detection (Meter::setDecimated) against the full-rate reference. The decimated
+    // meter is not expected to match it sample for sample: it weights the D samples of a group
+    // alike and holds back a group that is still open at the end of a block. MeteringCore.h
+    // bounds the resulting difference by 1.5 * (D - 1) / (fs * tau) of a step, so with samples
+    // no larger than full scale the readings may differ by that much, absolute, plus the
+    // reference's own rounding (Meter::toleranceDb). Odd block sizes leave groups open across
+    // blocks.
+    template <typename SampleType>
+    class DecimatedKernelTest : public juce::UnitTest
+    {
+    public:
+        explicit DecimatedKernelTest(const juce::String& name) : juce::UnitTest(name, "MeteringCore") {}
+
+        void runTest() override
+        {
+            const int blockSizes[] = { 1, 7, 33, 255, preparedBlockSize - 1, preparedBlockSize + 1,
+                                       3 * preparedBlockSize + 17, 8 * preparedBlockSize + 1 };
+
+            for (double sampleRate : { 96000.0, 192000.0 })
+            {
+                for (double timeConstant : { 0.05, 0.3, 1.0 })
+                {
+                    beginTest(juce::String(sampleRate, 0) + " Hz, " + juce::String(timeConstant * 1000.0, 0) + " ms");
+                    check(sampleRate, timeConstant, blockSizes);
+                }
+            }
+        }
+
+    private:
+        using MeterType = viau::Meter<viau::AbsDetector, viau::VUBallistics, 2, SampleType>;
+        static constexpr int preparedBlockSize = 512;
+
+        template <size_t NumSizes>
+        void check(double sampleRate, double timeConstant, const int (&blockSizes)[NumSizes])
+        {
+            MeterType meter;
+            meter.prepare(sampleRate, preparedBlockSize);
+            meter.setTimeConstant(timeConstant);
+            meter.setDecimated(true);
+
+            const int d = meter.getDecimationFactor();
+            expect(d > 1, "decimation factor " + juce::String(d));
+
+            const double timingTolerance = 1.5 * (double)(d - 1) / (sampleRate * timeConstant);
+            const double roundingTolerance = juce::Decibels::decibelsToGain(MeterType::toleranceDb) - 1.0;
+
+            TestSignal<SampleType> signal(2, blockSizes[NumSizes - 1]);
+            SampleType reference = 0;
+            double worstExcess = -1.0, worstDifference = 0.0;
+
+            for (int round = 0; round < 4; ++round)
+            {
+                for (int numSamples : blockSizes)
+                {
+                    const auto* const* channels = signal.next(numSamples);
+                    const double level = (double)meter.process(channels, 2, numSamples);
+                    reference = MeterType::processReference(reference, meter.getAlpha(), channels, 2, numSamples);
+
+                    const double difference = std::abs(level - (double)reference);
+                    worstDifference = juce::jmax(worstDifference, difference);
+                    worstExcess = juce::jmax(worstExcess, difference - timingTolerance - roundingTolerance * (double)reference);
+                }
+            }
+
+            expect(worstExcess <= 0.0, "D = " + juce::String(d) + ": decimated kernel " + juce::String(worstDifference * 1.0e6, 1)
+                                           + "e-6 from the reference, allowed " + juce::String(timingTolerance * 1.0e6, 1) + "e-6");
+        }
+    };
+
+    DecimatedKernelTest<float> decimatedFloatTest("Decimated kernel, float");
+    DecimatedKernelTest<double> decimatedDoubleTest("Decimated kernel, double");
+
+    //==============================================================================
+    // processSilence() must leave a meter where process() on as many zeros does, full-rate and
+    // decimated. The silent blocks follow signal blocks that leave a decimated group open, and
+    // include blocks too short to complete it; both meters then take the same signal again, so
+    // a partial group sum that one of them kept or lost shows up in the next readings.
+    template <typename SampleType>
+    class SilenceTest : public juce::UnitTest
+    {
+    public:
+        explicit SilenceTest(const juce::String& name) : juce::UnitTest(name, "MeteringCore") {}
+
+        void runTest() override
+        {
+            for (double sampleRate : { 44100.0, 192000.0 })
+            {
+                for (bool decimated : { false, true })
+                {
+                    beginTest(juce::String(sampleRate, 0) + " Hz" + (decimated ? ", decimated" : ""));
+                    check(sampleRate, decimated);
+                }
+            }
+        }
+
+    private:
+        using MeterType = viau::Meter<viau::AbsDetector, viau::VUBallistics, 2, SampleType>;
+
+        static constexpr int preparedBlockSize = 512;
+        static constexpr int signalBlockSize = preparedBlockSize + 3;   // not a multiple of any D
+        static constexpr double toleranceDb = 1.0e-4;                  // rounding only
+
+        void check(double sampleRate, bool decimated)
+        {
+            MeterType silenced, zeroed;
+            for (auto* meter : { &silenced, &zeroed })
+            {
+                meter->prepare(sampleRate, preparedBlockSize);
+                meter->setDecimated(decimated);
+            }
+
+            const int d = silenced.getDecimationFactor();
+            const int silentSizes[] = { 1, 2, d - 1, d, d + 1, 3 * d + 5, signalBlockSize };
+
+            TestSignal<SampleType> signal(2, signalBlockSize);
+            juce::AudioBuffer<SampleType> zeros(2, signalBlockSize);
+            zeros.clear();
+
+            double worstDb = 0.0;
+            auto compare = [&]
+                {
+                    for (int ch = -1; ch < 2; ++ch)
+                    {
+                        const auto a = ch < 0 ? silenced.getLevel() : silenced.getChannelLevel(ch);
+                        const auto b = ch < 0 ? zeroed.getLevel() : zeroed.getChannelLevel(ch);
+                        if (b > (SampleType)1.0e-6)
+                            worstDb = juce::jmax(worstDb, std::abs(juce::Decibels::gainToDecibels((double)a / (double)b)));
+                    }
+                };
+
+            for (int numSilent : silentSizes)
+            {
+                for (int i = 0; i < 2; ++i)
+                {
+                    const auto* const* channels = signal.next(signalBlockSize);
+                    silenced.process(channels, 2, signalBlockSize);
+                    zeroed.process(channels, 2, signalBlockSize);
+                    compare();
+                }
+
+                // A floor of zero keeps processSilence() from snapping the meter to rest
+                for (int numSamples : { numSilent, 1, numSilent })
+                {
+                    silenced.processSilence(2, numSamples, (SampleType)0);
+                    zeroed.process(zeros.getArrayOfReadPointers(), 2, numSamples);
+                    compare();
+                }
+            }
+
+            expect(worstDb <= toleranceDb, "processSilence " + juce::String(worstDb, 6) + " dB from process on zeros");
+        }
+    };
+
+    SilenceTest<float> silenceFloatTest("Silence, float");
+    SilenceTest<double> silenceDoubleTest("Silence, double");
+}
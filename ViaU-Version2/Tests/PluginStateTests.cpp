@@ -0,0 +1,199 @@
+// The binary session state (PluginStateCodec, see PluginState.h) on a ViaUAudioProcessor:
+// save and load, the compatibility rules for records and headers this build does not know,
+// damaged chunks, and the XML sessions of earlier builds, which setStateInformation() still
+// loads.
+//
+// Built with TestMain.cpp on the plugin's sources and run by ctest.
+
+#include "../Source/PluginProcessor.h"
+#include <algorithm>
+#include <random>
+#include <utility>
+
+namespace
+{
+    class PluginStateTest : public juce::UnitTest
+    {
+    public:
+        PluginStateTest() : juce::UnitTest("Plugin state", "PluginState") {}
+
+        void runTest() override
+        {
+            juce::ScopedJuceInitialiser_GUI juceInit;
+
+            beginTest("Save and load");
+            {
+                ViaUAudioProcessor source, dest;
+                apply(source, settings());
+
+                juce::MemoryBlock state;
+                source.getStateInformation(state);
+                dest.setStateInformation(state.getData(), (int)state.getSize());
+
+                for (auto* parameter : source.apvts.processor.getParameters())
+                    if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter))
+                        expectWithinAbsoluteError(plainValue(dest, ranged->getParameterID()),
+                                                  plainValue(source, ranged->getParameterID()), 1.0e-4f);
+            }
+
+            beginTest("Unknown parameters are skipped");
+            {
+                ViaUAudioProcessor processor;
+                auto records = toRecords(settings());
+                records.push_back({ PluginStateCodec::hashParameterID("notAParameter"), 1.0f });
+                records.push_back({ 0xffffffffu, 1.0f });
+
+                expect(load(processor, makeChunk(records)));
+                expectSettings(processor, settings());
+            }
+
+            beginTest("Missing parameters are reset to their default");
+            {
+                ViaUAudioProcessor processor;
+                apply(processor, settings());
+
+                auto partial = settings();
+                partial.erase(std::remove_if(partial.begin(), partial.end(),
+                                             [](const Setting& s) { return s.first == "referenceLevel"; }),
+                              partial.end());
+
+                expect(load(processor, makeChunk(toRecords(partial))));
+                expectSettings(processor, partial);
+                expectWithinAbsoluteError(plainValue(processor, "referenceLevel"), -18.0f, 1.0e-4f);
+            }
+
+            beginTest("Later versions' header and record fields are stepped over");
+            {
+                ViaUAudioProcessor processor;
+                expect(load(processor, makeChunk(toRecords(settings()), 2, 24, 12)));
+                expectSettings(processor, settings());
+            }
+
+            beginTest("Damaged chunks are rejected");
+            {
+                ViaUAudioProcessor processor;
+                apply(processor, settings());
+
+                juce::MemoryBlock saved;
+                processor.getStateInformation(saved);
+
+                std::vector<juce::MemoryBlock> damaged;
+                damaged.emplace_back(saved.getData(), saved.getSize() - 1);     // truncated record
+                damaged.emplace_back(saved.getData(), (size_t)10);              // truncated header
+                damaged.emplace_back();
+
+                juce::MemoryBlock garbage(64);
+                std::mt19937 rng{ 0x5eed };
+                for (size_t i = 0; i < garbage.getSize(); ++i)
+                    garbage[i] = (char)(rng() & 0xff);
+                damaged.push_back(garbage);
+
+                // Well formed but out of order, and with a hash twice
+                auto records = toRecords(settings());
+                std::sort(records.begin(), records.end());
+                std::swap(records.front(), records.back());
+                damaged.push_back(makeChunk(records, 1, 16, 8, false));
+
+                std::swap(records.front(), records.back());
+                records[1].first = records[0].first;
+                damaged.push_back(makeChunk(records, 1, 16, 8, false));
+
+                for (auto& chunk : damaged)
+                {
+                    expect(!load(processor, chunk), "damaged chunk loaded");
+                    processor.setStateInformation(chunk.getData(), (int)chunk.getSize());
+                    expectSettings(processor, settings());
+                }
+            }
+
+            beginTest("Sessions saved as XML");
+            {
+                ViaUAudioProcessor source, dest;
+                apply(source, settings());
+
+                juce::MemoryBlock state;
+                if (auto xml = source.apvts.copyState().createXml())
+                    juce::AudioProcessor::copyXmlToBinary(*xml, state);
+
+                expect(!PluginStateCodec::isPluginState(state.getData(), (int)state.getSize()));
+                dest.setStateInformation(state.getData(), (int)state.getSize());
+                expectSettings(dest, settings());
+            }
+        }
+
+    private:
+        using Setting = std::pair<juce::String, float>;                 // parameter ID, plain value
+        using Record = std::pair<juce::uint32, float>;                  // ID hash, plain value
+
+        // A value other than the default for parameters of every kind
+        static std::vector<Setting> settings()
+        {
+            return { { "displayMode", 2.0f }, { "truePeak", 1.0f }, { "spectrumBands", 0.0f },
+                     { "referenceLevel", -12.0f }, { "integrationTime", 600.0f },
+                     { "scaleFloor", -30.0f }, { "scaleCeiling", 6.0f } };
+        }
+
+        static std::vector<Record> toRecords(const std::vector<Setting>& settingsToUse)
+        {
+            std::vector<Record> records;
+            for (auto& setting : settingsToUse)
+                records.push_back({ PluginStateCodec::hashParameterID(setting.first), setting.second });
+            return records;
+        }
+
+        // A chunk in the format of PluginState.h, with the records sorted unless asked not to.
+        // Header and record bytes past the version 1 fields are filled with junk.
+        static juce::MemoryBlock makeChunk(std::vector<Record> records, juce::uint16 version = 1,
+                                           juce::uint16 headerSize = 16, juce::uint16 recordSize = 8, bool sort = true)
+        {
+            if (sort)
+                std::sort(records.begin(), records.end());
+
+            juce::MemoryOutputStream out;
+            out.writeInt((int)PluginStateHeader::expectedMagic);
+            out.writeShort((short)version);
+            out.writeShort((short)headerSize);
+            out.writeShort((short)recordSize);
+            out.writeShort(0);
+            out.writeInt((int)records.size());
+            out.writeRepeatedByte((juce::uint8)0xee, (size_t)headerSize - 16);
+
+            for (auto& record : records)
+            {
+                out.writeInt((int)record.first);
+                out.writeFloat(record.second);
+                out.writeRepeatedByte((juce::uint8)0xee, (size_t)recordSize - 8);
+            }
+
+            return out.getMemoryBlock();
+        }
+
+        static bool load(ViaUAudioProcessor& processor, const juce::MemoryBlock& chunk)
+        {
+            return PluginStateCodec(processor.apvts).load(chunk.getData(), (int)chunk.getSize());
+        }
+
+        static void apply(ViaUAudioProcessor& processor, const std::vector<Setting>& settingsToUse)
+        {
+            for (auto& setting : settingsToUse)
+            {
+                auto* parameter = processor.apvts.getParameter(setting.first);
+                parameter->setValueNotifyingHost(parameter->convertTo0to1(setting.second));
+            }
+        }
+
+        static float plainValue(ViaUAudioProcessor& processor, const juce::String& parameterID)
+        {
+            auto* parameter = processor.apvts.getParameter(parameterID);
+            return parameter->convertFrom0to1(parameter->getValue());
+        }
+
+        void expectSettings(ViaUAudioProcessor& processor, const std::vector<Setting>& expected)
+        {
+            for (auto& setting : expected)
+                expectWithinAbsoluteError(plainValue(processor, setting.first), setting.second, 1.0e-4f, setting.first);
+        }
+    };
+
+    PluginStateTest pluginStateTest;
+}
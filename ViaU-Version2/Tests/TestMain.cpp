@@ -0,0 +1,19 @@
+// Entry point of the unit test applications: runs every juce::UnitTest linked into the
+// executable and exits with code 1 if any of them fails.
+
+#include <juce_core/juce_core.h>
+#include <iostream>
+
+int main()
+{
+    juce::UnitTestRunner runner;
+    runner.setAssertOnFailure(false);
+    runner.runAllTests();
+
+    int numFailures = 0;
+    for (int i = 0; i < runner.getNumResults(); ++i)
+        numFailures += runner.getResult(i)->failures;
+
+    std::cout << (numFailures == 0 ? "All tests passed" : juce::String(numFailures) + " failure(s)") << std::endl;
+    return numFailures == 0 ? 0 : 1;
+}
@@ -0,0 +1,427 @@
+// Headless VU / loudness analyser for batches of WAV and AIFF files.
+//
+// Build as a JUCE console application with juce_audio_formats, together with
+// ../Source/LoudnessMeter.cpp (the VU meter is header-only: ../Source/VUBlockMeter.h, over
+// ViaU-Common/MeteringCore.h).
+// Usage:
+//
+//   ViaUBatchAnalyzer [--json] [--threads <n>] [--threshold <VU>] [--block <samples>]
+//                     [--reference <dBFS>] [--floor <VU>] [--ceiling <VU>] [--tau <ms>]
+//                     [--output <file>] <file or folder>...
+//
+// Folders are searched recursively for .wav, .aif and .aiff files. Every file goes through
+// the same per-block metering as ViaUAudioProcessor::processBlock (see
+// ../Source/VUBlockMeter.h), in blocks of --block samples (512 by default), with the
+// plugin's default calibration unless --reference (the dBFS level of 0 VU), --floor and
+// --ceiling (the scale) or --tau (the integration time) say otherwise. Like the plugin's
+// parameters, these are limited to -24..-8 dBFS, -40..-10 VU, 0..+6 VU and 50..1000 ms. The
+// VU reading after each block is what the plugin would publish for it. The results are
+// written as CSV, or JSON with --json, to stdout or --output, one row per file in the order
+// given:
+//
+//   maxVU           highest block reading, VU units (--floor..--ceiling, -20..+3 by default)
+//   peakDbfs        highest sample, dBFS
+//   peakHits        blocks lighting the plugin's peak indicator (reading 0 VU or more)
+//   secondsOver     time in blocks reading --threshold VU or more (0 VU by default)
+//   integratedLufs  EBU R128 integrated loudness; loudnessRange LRA in LU
+//
+// Files are read through memory-mapped readers (falling back to ordinary streams for files
+// that can't be mapped) on one thread per core. Each thread starts with an equal share of
+// the files and steals from the others once its own share is done. Files/s and samples/s
+// go to stderr.
+
+#include "../Source/LoudnessMeter.h"
+#include "../Source/VUBlockMeter.h"
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    struct Settings
+    {
+        int blockSize = 512;
+        float thresholdVU = 0.0f;
+        VUScale scale;
+        double timeConstantSeconds = viau::VUBallistics::timeConstantSeconds;
+    };
+
+    struct FileResult
+    {
+        juce::File file;
+        juce::String error;                         // empty on success
+        double sampleRate = 0.0;
+        int numChannels = 0;
+        juce::int64 numSamples = 0;
+        float maxVU = -20.0f;
+        float peakDbfs = -std::numeric_limits<float>::infinity();
+        juce::int64 peakHits = 0;
+        double secondsOver = 0.0;
+        float integratedLufs = LoudnessMeter::noValue;
+        float loudnessRange = 0.0f;
+    };
+
+    //==============================================================================
+    // Each worker owns a contiguous range of file indices, packed as (begin << 32 | end) into
+    // one atomic word. The owner takes files from the front; a worker whose range is empty
+    // steals from the back of the fullest one. Both ends are claimed with a CAS on the same
+    // word, so every file is taken exactly once, without locks.
+    class WorkStealingQueue
+    {
+    public:
+        WorkStealingQueue(int numItems, int numWorkers)
+            : ranges((size_t)numWorkers)
+        {
+            for (int w = 0; w < numWorkers; ++w)
+            {
+                const auto begin = (juce::uint64)((juce::int64)numItems * w / numWorkers);
+                const auto end = (juce::uint64)((juce::int64)numItems * (w + 1) / numWorkers);
+                ranges[(size_t)w].value.store((begin << 32) | end);
+            }
+        }
+
+        // Next item for this worker, or -1 once every range is empty
+        int next(int worker) noexcept
+        {
+            if (const int item = take(worker, true); item >= 0)
+                return item;
+
+            for (;;)
+            {
+                int victim = -1;
+                juce::uint64 mostLeft = 0;
+
+                for (size_t w = 0; w < ranges.size(); ++w)
+                {
+                    const auto range = ranges[w].value.load(std::memory_order_relaxed);
+                    const auto left = (range & 0xffffffffu) - (range >> 32);
+
+                    if (left > mostLeft)
+                    {
+                        mostLeft = left;
+                        victim = (int)w;
+                    }
+                }
+
+                if (victim < 0)
+                    return -1;
+
+                if (const int item = take(victim, false); item >= 0)
+                    return item;
+            }
+        }
+
+    private:
+        int take(int worker, bool fromFront) noexcept
+        {
+            auto& word = ranges[(size_t)worker].value;
+            auto range = word.load(std::memory_order_relaxed);
+
+            for (;;)
+            {
+                const auto begin = range >> 32;
+                const auto end = range & 0xffffffffu;
+
+                if (begin >= end)
+                    return -1;
+
+                const auto updated = fromFront ? ((begin + 1) << 32) | end : (begin << 32) | (end - 1);
+                if (word.compare_exchange_weak(range, updated, std::memory_order_acq_rel))
+                    return (int)(fromFront ? begin : end - 1);
+            }
+        }
+
+        struct alignas(64) Range
+        {
+            std::atomic<juce::uint64> value{ 0 };
+        };
+
+        std::vector<Range> ranges;
+    };
+
+    //==============================================================================
+    class Analyser
+    {
+    public:
+        explicit Analyser(const Settings& settingsToUse) : settings(settingsToUse) {}
+
+        void analyse(FileResult& result)
+        {
+            auto reader = openReader(result.file);
+            if (reader == nullptr)
+            {
+                result.error = "unsupported or unreadable file";
+                return;
+            }
+
+            result.sampleRate = reader->sampleRate;
+            result.numChannels = (int)reader->numChannels;
+            result.numSamples = reader->lengthInSamples;
+
+            if (result.sampleRate <= 0.0 || result.numChannels <= 0)
+            {
+                result.error = "no audio";
+                return;
+            }
+
+            const int numChannels = juce::jmin(result.numChannels, viau::maxChannels);
+            const int blockSize = settings.blockSize;
+            buffer.setSize(numChannels, blockSize, false, false, true);
+
+            viau::Meter<viau::AbsDetector, viau::VUBallistics> meter;
+            meter.prepare(result.sampleRate, blockSize);
+            meter.setTimeConstant(settings.timeConstantSeconds);
+            const double floorGain = settings.scale.getFloorGain();
+            result.maxVU = settings.scale.minVU;
+
+            auto layout = juce::AudioChannelSet::canonicalChannelSet(numChannels);
+            if (layout.size() != numChannels)
+                layout = juce::AudioChannelSet::discreteChannels(numChannels);
+
+            loudness.prepare(result.sampleRate, layout);
+
+            float peak = 0.0f;
+            juce::int64 samplesOver = 0;
+
+            for (juce::int64 position = 0; position < result.numSamples; position += blockSize)
+            {
+                const int n = (int)juce::jmin((juce::int64)blockSize, result.numSamples - position);
+                reader->read(&buffer, 0, n, position, true, true);
+
+                const auto channels = buffer.getArrayOfReadPointers();
+                float blockPeak = 0.0f;
+                for (int ch = 0; ch < numChannels; ++ch)
+                    blockPeak = juce::jmax(blockPeak, buffer.getMagnitude(ch, 0, n));
+                peak = juce::jmax(peak, blockPeak);
+
+                const auto reading = viau::meterVUBlock(meter, settings.scale, floorGain, channels, numChannels, numChannels, n,
+                                                        blockPeak < viau::silenceThreshold);
+                loudness.process(channels, numChannels, n);
+
+                result.maxVU = juce::jmax(result.maxVU, reading.vu);
+                if (reading.peakHit)
+                    ++result.peakHits;
+                if (reading.vu >= settings.thresholdVU)
+                    samplesOver += n;
+            }
+
+            result.peakDbfs = peak > 0.0f ? juce::Decibels::gainToDecibels(peak, -1000.0f) : -std::numeric_limits<float>::infinity();
+            result.secondsOver = (double)samplesOver / result.sampleRate;
+            result.integratedLufs = loudness.getIntegrated();
+            result.loudnessRange = loudness.getLoudnessRange();
+        }
+
+    private:
+        std::unique_ptr<juce::AudioFormatReader> openReader(const juce::File& file)
+        {
+            juce::AudioFormat* format = nullptr;
+            if (file.hasFileExtension("wav"))
+                format = &wav;
+            else if (file.hasFileExtension("aif;aiff"))
+                format = &aiff;
+            else
+                return nullptr;
+
+            std::unique_ptr<juce::MemoryMappedAudioFormatReader> mapped(format->createMemoryMappedReader(file));
+            if (mapped != nullptr && mapped->mapEntireFile())
+                return mapped;
+
+            // Not mappable (e.g. a compressed AIFF-C); read it as a stream instead
+            return std::unique_ptr<juce::AudioFormatReader>(format->createReaderFor(file.createInputStream().release(), true));
+        }
+
+        const Settings& settings;
+        juce::WavAudioFormat wav;
+        juce::AiffAudioFormat aiff;
+        juce::AudioBuffer<float> buffer;
+        LoudnessMeter loudness;
+    };
+
+    //==============================================================================
+    juce::Array<juce::File> collectFiles(const juce::StringArray& paths)
+    {
+        juce::Array<juce::File> files;
+
+        for (auto& path : paths)
+        {
+            const auto target = juce::File::getCurrentWorkingDirectory().getChildFile(path);
+
+            if (target.isDirectory())
+            {
+                auto found = target.findChildFiles(juce::File::findFiles, true, "*.wav;*.aif;*.aiff");
+                found.sort();
+                files.addArray(found);
+            }
+            else
+            {
+                files.add(target);
+            }
+        }
+
+        return files;
+    }
+
+    juce::String formatNumber(double value, int decimals)
+    {
+        return std::isfinite(value) ? juce::String(value, decimals) : juce::String(value > 0.0 ? "inf" : "-inf");
+    }
+
+    juce::String toCsv(const std::vector<FileResult>& results)
+    {
+        juce::String text;
+        text << "file,sampleRate,channels,seconds,maxVU,peakDbfs,peakHits,secondsOver,integratedLufs,loudnessRange,error\n";
+
+        for (auto& r : results)
+        {
+            text << r.file.getFullPathName().quoted() << ","
+                 << juce::String(r.sampleRate, 0) << ","
+                 << r.numChannels << ","
+                 << formatNumber(r.sampleRate > 0.0 ? (double)r.numSamples / r.sampleRate : 0.0, 3) << ","
+                 << formatNumber(r.maxVU, 2) << ","
+                 << formatNumber(r.peakDbfs, 2) << ","
+                 << juce::String(r.peakHits) << ","
+                 << formatNumber(r.secondsOver, 3) << ","
+                 << formatNumber(r.integratedLufs, 2) << ","
+                 << formatNumber(r.loudnessRange, 2) << ","
+                 << r.error.quoted() << "\n";
+        }
+
+        return text;
+    }
+
+    juce::String toJson(const std::vector<FileResult>& results)
+    {
+        // JSON has no infinities; silence gets null instead
+        auto number = [](double value) { return std::isfinite(value) ? juce::var(value) : juce::var(); };
+        juce::Array<juce::var> rows;
+
+        for (auto& r : results)
+        {
+            auto* row = new juce::DynamicObject();
+            row->setProperty("file", r.file.getFullPathName());
+            row->setProperty("sampleRate", r.sampleRate);
+            row->setProperty("channels", r.numChannels);
+            row->setProperty("seconds", r.sampleRate > 0.0 ? (double)r.numSamples / r.sampleRate : 0.0);
+            row->setProperty("maxVU", r.maxVU);
+            row->setProperty("peakDbfs", number(r.peakDbfs));
+            row->setProperty("peakHits", r.peakHits);
+            row->setProperty("secondsOver", r.secondsOver);
+            row->setProperty("integratedLufs", number(r.integratedLufs));
+            row->setProperty("loudnessRange", r.loudnessRange);
+            if (r.error.isNotEmpty())
+                row->setProperty("error", r.error);
+            rows.add(juce::var(row));
+        }
+
+        return juce::JSON::toString(juce::var(rows)) + "\n";
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ArgumentList args(argc, argv);
+
+    return juce::ConsoleApplication::invokeCatchingFailures([&]
+        {
+            Settings settings;
+            if (args.containsOption("--block"))
+                settings.blockSize = juce::jlimit(16, 65536, args.getValueForOption("--block").getIntValue());
+            if (args.containsOption("--threshold"))
+                settings.thresholdVU = (float)args.getValueForOption("--threshold").getDoubleValue();
+            // The plugin's "referenceLevel", "scaleFloor", "scaleCeiling" and "integrationTime" ranges
+            if (args.containsOption("--reference"))
+                settings.scale.referenceDbfs = juce::jlimit(-24.0f, -8.0f, (float)args.getValueForOption("--reference").getDoubleValue());
+            if (args.containsOption("--floor"))
+                settings.scale.minVU = juce::jlimit(-40.0f, -10.0f, (float)args.getValueForOption("--floor").getDoubleValue());
+            if (args.containsOption("--ceiling"))
+                settings.scale.maxVU = juce::jlimit(VUScale::peakVU, 6.0f, (float)args.getValueForOption("--ceiling").getDoubleValue());
+            if (args.containsOption("--tau"))
+                settings.timeConstantSeconds = juce::jlimit(50.0, 1000.0, args.getValueForOption("--tau").getDoubleValue()) * 0.001;
+
+            const int numThreads = args.containsOption("--threads")
+                ? juce::jmax(1, args.getValueForOption("--threads").getIntValue())
+                : juce::jmax(1, (int)std::thread::hardware_concurrency());
+
+            // Everything that is not an option (or an option's value) is a file or folder
+            juce::StringArray paths;
+            for (int i = 0; i < args.size(); ++i)
+            {
+                const auto& arg = args[i];
+                if (arg.isOption())
+                {
+                    if (!arg.text.contains("=") && (arg == "--threads" || arg == "--threshold" || arg == "--block"
+                                                  || arg == "--reference" || arg == "--floor" || arg == "--ceiling"
+                                                  || arg == "--tau" || arg == "--output"))
+                        ++i;
+                    continue;
+                }
+
+                paths.add(arg.text);
+            }
+
+            const auto files = collectFiles(paths);
+            if (files.isEmpty())
+                juce::ConsoleApplication::fail("Usage: ViaUBatchAnalyzer [--json] [--threads <n>] [--threshold <VU>] "
+                                               "[--block <samples>] [--reference <dBFS>] [--floor <VU>] [--ceiling <VU>] "
+                                               "[--tau <ms>] [--output <file>] <file or folder>...");
+
+            std::vector<FileResult> results((size_t)files.size());
+            for (int i = 0; i < files.size(); ++i)
+                results[(size_t)i].file = files[i];
+
+            const int numWorkers = juce::jmin(numThreads, files.size());
+            WorkStealingQueue queue(files.size(), numWorkers);
+            const auto start = Clock::now();
+
+            std::vector<std::thread> workers;
+            for (int w = 0; w < numWorkers; ++w)
+            {
+                workers.emplace_back([&, w]
+                    {
+                        Analyser analyser(settings);
+                        for (int item; (item = queue.next(w)) >= 0;)
+                            analyser.analyse(results[(size_t)item]);
+                    });
+            }
+
+            for (auto& worker : workers)
+                worker.join();
+
+            const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+            juce::int64 totalSamples = 0;
+            int numFailed = 0;
+
+            for (auto& r : results)
+            {
+                totalSamples += r.error.isEmpty() ? r.numSamples : 0;
+                numFailed += r.error.isEmpty() ? 0 : 1;
+            }
+
+            const auto text = args.containsOption("--json") ? toJson(results) : toCsv(results);
+
+            if (args.containsOption("--output"))
+            {
+                const auto output = args.getFileForOption("--output");
+                if (!output.replaceWithText(text))
+                    juce::ConsoleApplication::fail("Could not write " + output.getFullPathName());
+            }
+            else
+            {
+                std::cout << text;
+            }
+
+            std::cerr << files.size() << " file(s), " << numFailed << " failed, " << numWorkers << " thread(s), "
+                      << juce::String(seconds, 2) << " s: "
+                      << juce::String((double)files.size() / seconds, 1) << " files/s, "
+                      << juce::String((double)totalSamples / seconds / 1.0e6, 1) << " M samples/s" << std::endl;
+
+            return numFailed > 0 ? 1 : 0;
+        });
+}
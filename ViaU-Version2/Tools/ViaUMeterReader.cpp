@@ -0,0 +1,223 @@
+// Headless reader for the shared-memory meter export (see ../Source/SharedMeterLayout.h).
+//
+// Plain C++17 and POSIX, no JUCE:
+//
+//   c++ -std=c++17 -O2 ViaUMeterReader.cpp -o ViaUMeterReader        (add -lrt on older glibc)
+//
+// Usage:
+//
+//   ViaUMeterReader                     print every exporting instance once
+//   ViaUMeterReader --watch [ms]        keep printing, every 250 ms by default
+//   ViaUMeterReader --bench [seconds]   read all slots in a tight loop for 5 s by default and
+//                                       report the cost of a slot read, seqlock retries, and
+//                                       how old the readings were (publish -> read latency)
+
+#include "../Source/SharedMeterLayout.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace
+{
+    const viau::shm::Segment* mapSegment()
+    {
+        const int fd = ::shm_open(viau::shm::segmentName, O_RDONLY, 0);
+        if (fd < 0)
+        {
+            std::fprintf(stderr, "No ViaU meters exported (%s: %s)\n", viau::shm::segmentName, std::strerror(errno));
+            return nullptr;
+        }
+
+        // Touching pages past the end of the object raises SIGBUS, so only map a segment that
+        // is at least a whole Segment: one being created is still empty, and an older build
+        // may have sized it smaller.
+        struct stat info {};
+        if (::fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(viau::shm::Segment))
+        {
+            std::fprintf(stderr, "%s is not ready or has an incompatible layout (%lld of %zu bytes)\n",
+                         viau::shm::segmentName, (long long)info.st_size, sizeof(viau::shm::Segment));
+            ::close(fd);
+            return nullptr;
+        }
+
+        void* address = ::mmap(nullptr, sizeof(viau::shm::Segment), PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+
+        if (address == MAP_FAILED)
+        {
+            std::fprintf(stderr, "mmap failed: %s\n", std::strerror(errno));
+            return nullptr;
+        }
+
+        // The header's magic and version are checked before any slot is read
+        auto* segment = static_cast<const viau::shm::Segment*>(address);
+        if (!viau::shm::isCompatible(*segment))
+        {
+            std::fprintf(stderr, "%s has an incompatible layout\n", viau::shm::segmentName);
+            ::munmap(address, sizeof(viau::shm::Segment));
+            return nullptr;
+        }
+
+        return segment;
+    }
+
+    bool isLive(const viau::shm::Slot& slot)
+    {
+        const auto owner = slot.owner.load(std::memory_order_acquire);
+        const auto pid = (pid_t)viau::shm::ownerPid(owner);
+        return owner != 0 && pid > 0 && (::kill(pid, 0) == 0 || errno == EPERM);
+    }
+
+    const char* formatLufs(float value, char* buffer, size_t size)
+    {
+        if (std::isfinite(value))
+            std::snprintf(buffer, size, "%6.1f", value);
+        else
+            std::snprintf(buffer, size, "%6s", "-inf");
+        return buffer;
+    }
+
+    void printTable(const viau::shm::Segment& segment)
+    {
+        std::printf("%-4s %-24s %7s %8s %4s %6s %6s %6s %5s %8s\n",
+                    "slot", "name", "VU", "peak dB", "ch", "M", "S", "I", "LRA", "age ms");
+
+        const auto now = viau::shm::nowNs();
+        int numShown = 0;
+
+        for (int i = 0; i < viau::shm::maxSlots; ++i)
+        {
+            const auto& slot = segment.slots[i];
+            viau::shm::MeterData data;
+
+            if (!isLive(slot) || !viau::shm::readSlot(slot, data) || !data.active)
+                continue;
+
+            char name[viau::shm::nameLength];
+            viau::shm::readName(slot, name);
+
+            char m[16], s[16], integrated[16];
+            const double peakDb = data.peak > 0.0f ? 20.0 * std::log10((double)data.peak) : -INFINITY;
+            const double ageMs = now > data.publishTimeNs ? (double)(now - data.publishTimeNs) * 1.0e-6 : 0.0;
+
+            std::printf("%-4d %-24.24s %7.1f %8.1f %4d %6s %6s %6s %5.1f %8.1f%s%s\n",
+                        i, name, data.vu, peakDb, data.numChannels,
+                        formatLufs(data.momentary, m, sizeof(m)),
+                        formatLufs(data.shortTerm, s, sizeof(s)),
+                        formatLufs(data.integrated, integrated, sizeof(integrated)),
+                        data.loudnessRange, ageMs,
+                        data.peakHit ? "  PEAK" : "", data.idle ? "  idle" : "");
+            ++numShown;
+        }
+
+        std::printf("%d meter(s)\n", numShown);
+    }
+
+    void bench(const viau::shm::Segment& segment, double seconds)
+    {
+        using Clock = std::chrono::steady_clock;
+
+        std::vector<int> live;
+        for (int i = 0; i < viau::shm::maxSlots; ++i)
+            if (isLive(segment.slots[i]))
+                live.push_back(i);
+
+        if (live.empty())
+        {
+            std::printf("No live slots to read\n");
+            return;
+        }
+
+        std::vector<double> readNs, ageUs;
+        readNs.reserve(1 << 20);
+        ageUs.reserve(1 << 20);
+        long long numReads = 0, numFailed = 0;
+        const auto end = Clock::now() + std::chrono::duration<double>(seconds);
+
+        while (Clock::now() < end)
+        {
+            for (int i : live)
+            {
+                viau::shm::MeterData data;
+                const auto start = viau::shm::nowNs();
+                const bool ok = viau::shm::readSlot(segment.slots[i], data);
+                const auto done = viau::shm::nowNs();
+
+                ++numReads;
+                if (!ok)
+                {
+                    ++numFailed;
+                    continue;
+                }
+
+                if (readNs.size() < readNs.capacity())
+                {
+                    readNs.push_back((double)(done - start));
+                    if (data.active && data.publishTimeNs > 0 && done > data.publishTimeNs)
+                        ageUs.push_back((double)(done - data.publishTimeNs) * 1.0e-3);
+                }
+            }
+        }
+
+        auto report = [](const char* what, std::vector<double>& values, const char* unit)
+            {
+                if (values.empty())
+                    return;
+
+                std::sort(values.begin(), values.end());
+                double sum = 0.0;
+                for (auto v : values)
+                    sum += v;
+
+                auto at = [&](double p) { return values[(size_t)std::min((double)values.size() - 1, p * (double)values.size())]; };
+                std::printf("%-10s mean %9.2f  p50 %9.2f  p99 %9.2f  max %9.2f %s\n",
+                            what, sum / (double)values.size(), at(0.50), at(0.99), values.back(), unit);
+            };
+
+        std::printf("%zu live slot(s), %lld reads, %lld gave up after retries\n", live.size(), numReads, numFailed);
+        report("read", readNs, "ns");
+        report("age", ageUs, "us");
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    const char* mode = argc > 1 ? argv[1] : "";
+    const auto* segment = mapSegment();
+
+    if (segment == nullptr)
+        return 1;
+
+    if (std::strcmp(mode, "--bench") == 0)
+    {
+        bench(*segment, argc > 2 ? std::atof(argv[2]) : 5.0);
+    }
+    else if (std::strcmp(mode, "--watch") == 0)
+    {
+        const int intervalMs = argc > 2 ? std::max(10, std::atoi(argv[2])) : 250;
+        for (;;)
+        {
+            std::printf("\033[H\033[2J");
+            printTable(*segment);
+            std::fflush(stdout);
+            std::this_thread::sleep_for(std::chrono::milliseconds(intervalMs));
+        }
+    }
+    else
+    {
+        printTable(*segment);
+    }
+
+    return 0;
+}